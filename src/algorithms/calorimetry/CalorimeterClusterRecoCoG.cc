@@ -18,6 +18,7 @@
 #include <edm4hep/MCParticle.h>
 
 #include "CalorimeterClusterRecoCoG.h"
+#include "extensions/spdlog/SpdlogMacros.h"
 
 namespace eicrecon {
 
@@ -58,7 +59,7 @@ namespace eicrecon {
       // skip null clusters
       if (cl == nullptr) continue;
 
-      m_log->debug("{} hits: {} GeV, ({}, {}, {})", cl->getNhits(), cl->getEnergy() / dd4hep::GeV, cl->getPosition().x / dd4hep::mm, cl->getPosition().y / dd4hep::mm, cl->getPosition().z / dd4hep::mm);
+      EICRECON_DEBUG(m_log, "{} hits: {} GeV, ({}, {}, {})", cl->getNhits(), cl->getEnergy() / dd4hep::GeV, cl->getPosition().x / dd4hep::mm, cl->getPosition().y / dd4hep::mm, cl->getPosition().z / dd4hep::mm);
       clusters->push_back(*cl);
 
       // If mcHits are available, associate cluster with MCParticle
@@ -104,13 +105,15 @@ namespace eicrecon {
         if (!(mchit != mchits->end())) {
           // break if no matching hit found for this CellID
           m_log->warn("Proto-cluster has highest energy in CellID {}, but no mc hit with that CellID was found.", pclhit->getCellID());
-          m_log->trace("Proto-cluster hits: ");
-          for (const auto& pclhit1: pclhits) {
-            m_log->trace("{}: {}", pclhit1.getCellID(), pclhit1.getEnergy());
-          }
-          m_log->trace("MC hits: ");
-          for (const auto& mchit1: *mchits) {
-            m_log->trace("{}: {}", mchit1.getCellID(), mchit1.getEnergy());
+          if (EICRECON_LOG_ENABLED(m_log, trace)) {
+            m_log->trace("Proto-cluster hits: ");
+            for (const auto& pclhit1: pclhits) {
+              m_log->trace("{}: {}", pclhit1.getCellID(), pclhit1.getEnergy());
+            }
+            m_log->trace("MC hits: ");
+            for (const auto& mchit1: *mchits) {
+              m_log->trace("{}: {}", mchit1.getCellID(), mchit1.getEnergy());
+            }
           }
           break;
         }
@@ -118,10 +121,12 @@ namespace eicrecon {
         // 3. find mchit's MCParticle
         const auto& mcp = mchit->getContributions(0).getParticle();
 
-        m_log->debug("cluster has largest energy in cellID: {}", pclhit->getCellID());
-        m_log->debug("pcl hit with highest energy {} at index {}", pclhit->getEnergy(), pclhit->getObjectID().index);
-        m_log->debug("corresponding mc hit energy {} at index {}", mchit->getEnergy(), mchit->getObjectID().index);
-        m_log->debug("from MCParticle index {}, PDG {}, {}", mcp.getObjectID().index, mcp.getPDG(), edm4eic::magnitude(mcp.getMomentum()));
+        if (EICRECON_LOG_ENABLED(m_log, debug)) {
+          m_log->debug("cluster has largest energy in cellID: {}", pclhit->getCellID());
+          m_log->debug("pcl hit with highest energy {} at index {}", pclhit->getEnergy(), pclhit->getObjectID().index);
+          m_log->debug("corresponding mc hit energy {} at index {}", mchit->getEnergy(), mchit->getObjectID().index);
+          m_log->debug("from MCParticle index {}, PDG {}, {}", mcp.getObjectID().index, mcp.getPDG(), edm4eic::magnitude(mcp.getMomentum()));
+        }
 
         // set association
         auto clusterassoc = associations->create();
@@ -143,7 +148,7 @@ edm4eic::Cluster* CalorimeterClusterRecoCoG::reconstruct(const edm4eic::ProtoClu
   edm4eic::MutableCluster cl;
   cl.setNhits(pcl.hits_size());
 
-  m_log->debug("hit size = {}", pcl.hits_size());
+  EICRECON_DEBUG(m_log, "hit size = {}", pcl.hits_size());
 
   // no hits
   if (pcl.hits_size() == 0) {
@@ -161,7 +166,7 @@ edm4eic::Cluster* CalorimeterClusterRecoCoG::reconstruct(const edm4eic::ProtoClu
   for (unsigned i = 0; i < pcl.getHits().size(); ++i) {
     const auto& hit   = pcl.getHits()[i];
     const auto weight = pcl.getWeights()[i];
-    m_log->debug("hit energy = {} hit weight: {}", hit.getEnergy(), weight);
+    EICRECON_DEBUG(m_log, "hit energy = {} hit weight: {}", hit.getEnergy(), weight);
     auto energy = hit.getEnergy() * weight;
     totalE += energy;
     if (energy > maxE) {
@@ -44,10 +44,11 @@ void CalorimeterHitsMerger::init(const dd4hep::Detector* detector, std::shared_p
 }
 
 std::unique_ptr<edm4eic::CalorimeterHitCollection> CalorimeterHitsMerger::process(const edm4eic::CalorimeterHitCollection &input) {
+    EventArena::Scope arena_scope;
     auto output = std::make_unique<edm4eic::CalorimeterHitCollection>();
 
     // find the hits that belong to the same group (for merging)
-    std::unordered_map<uint64_t, std::vector<std::size_t>> merge_map;
+    EventArena::unordered_map<uint64_t, EventArena::vector<std::size_t>> merge_map(EventArena::resource());
     std::size_t ix = 0;
     for (const auto &h : input) {
         uint64_t id = h.getCellID() & id_mask;
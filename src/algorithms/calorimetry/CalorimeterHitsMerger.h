@@ -23,6 +23,7 @@
 #include <edm4eic/vector_utils.h>
 #include <spdlog/spdlog.h>
 
+#include "algorithms/interfaces/EventArena.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 #include "CalorimeterHitsMergerConfig.h"
 
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2023, Christopher Dilks
+
+/*  Merging of hits on the same cell within a time window
+ *
+ *  Hits are stored as contiguous (cellID, time, charge) arrays. `Merge` sorts
+ *  them by cellID and time, then sweeps once over the sorted hits: a hit joins
+ *  the current group if it is on the same cell and its time is within `window`
+ *  of the first (earliest) hit of the group; otherwise it starts a new group.
+ *
+ *  The buffers are kept between events, so reuse one instance per algorithm.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace eicrecon {
+
+  class HitTimeWindowMerger {
+    public:
+
+      using CellIDType = std::uint64_t;
+
+      // group of merged hits
+      struct Group {
+        CellIDType  cellID;
+        double      time;   // time of the earliest hit
+        double      charge; // sum of the hit charges
+        std::size_t begin;  // hits of this group are `GetOrder()[begin]`, ..., `GetOrder()[end-1]`
+        std::size_t end;
+        std::size_t size() const { return end - begin; }
+      };
+
+      // use as `window` to merge all hits on the same cell
+      static constexpr double kNoWindow = std::numeric_limits<double>::infinity();
+
+      void Clear() {
+        m_cellID.clear();
+        m_time.clear();
+        m_charge.clear();
+        m_order.clear();
+        m_groups.clear();
+      }
+
+      void Reserve(std::size_t num_hits) {
+        m_cellID.reserve(num_hits);
+        m_time.reserve(num_hits);
+        m_charge.reserve(num_hits);
+      }
+
+      // add a hit; returns its index, which is used in `GetOrder()`
+      std::size_t Add(CellIDType cellID, double time, double charge) {
+        m_cellID.push_back(cellID);
+        m_time.push_back(time);
+        m_charge.push_back(charge);
+        return m_cellID.size() - 1;
+      }
+
+      std::size_t GetNumHits() const { return m_cellID.size(); }
+
+      // group the hits; set `sorted` if they were added ordered by cellID and time
+      void Merge(double window, bool sorted = false) {
+        auto num_hits = m_cellID.size();
+        m_order.resize(num_hits);
+        std::iota(m_order.begin(), m_order.end(), 0);
+        if(!sorted)
+          std::sort(m_order.begin(), m_order.end(), [this] (std::size_t a, std::size_t b) {
+              if(m_cellID[a] != m_cellID[b]) return m_cellID[a] < m_cellID[b];
+              if(m_time[a]   != m_time[b])   return m_time[a]   < m_time[b];
+              return a < b;
+              });
+
+        m_groups.clear();
+        for(std::size_t i = 0; i < num_hits; i++) {
+          auto hit = m_order[i];
+          if(m_groups.empty() || m_groups.back().cellID != m_cellID[hit] || m_time[hit] - m_groups.back().time > window)
+            m_groups.push_back({m_cellID[hit], m_time[hit], 0.0, i, i});
+          auto& group = m_groups.back();
+          group.charge += m_charge[hit];
+          group.end     = i + 1;
+        }
+      }
+
+      // results of `Merge`
+      const std::vector<Group>&       GetGroups() const { return m_groups; }
+      const std::vector<std::size_t>& GetOrder()  const { return m_order; }
+
+    private:
+
+      std::vector<CellIDType>  m_cellID;
+      std::vector<double>      m_time;
+      std::vector<double>      m_charge;
+      std::vector<std::size_t> m_order;  // hit indices, sorted by cellID and time
+      std::vector<Group>       m_groups;
+  };
+
+}
@@ -75,29 +75,33 @@ eicrecon::PhotoMultiplierHitDigiResult eicrecon::PhotoMultiplierHitDigi::Algorit
     )
 {
         m_log->trace("{:=^70}"," call PhotoMultiplierHitDigi::AlgorithmProcess ");
-        std::unordered_map<CellIDType, std::vector<HitData>> hit_groups;
         // collect the photon hit in the same cell
         // calculate signal
+        // overall safety factor and quantum efficiency
+        qe_pass_all(sim_hits);
+
+        m_pixel_hits.clear();
         m_log->trace("{:-<70}","Loop over simulated hits ");
-        for(std::size_t sim_hit_index = 0; sim_hit_index < sim_hits->size(); sim_hit_index++) {
+        for(auto sim_hit_index : qe_accepted) {
             const auto& sim_hit = sim_hits->at(sim_hit_index);
-            auto edep_eV = sim_hit.getEDep() * 1e9; // [GeV] -> [eV] // FIXME: use common unit converters, when available
-            auto id      = sim_hit.getCellID();
-            m_log->trace("hit: pixel id={:#018X}  edep = {} eV", id, edep_eV);
-
-            // overall safety factor
-            if (m_rngUni() > m_cfg.safetyFactor) continue;
-
-            // quantum efficiency
-            if (!qe_pass(edep_eV, m_rngUni())) continue;
+            auto id = sim_hit.getCellID();
+            m_log->trace("hit: pixel id={:#018X}  edep = {} eV", id, sim_hit.getEDep() * 1e9);
 
             // pixel gap cuts
             // FIXME: generalize; this assumes the segmentation is `CartesianGridXY`
             dd4hep::Position pos_pixel, pos_hit, pos_hit_global;
             if(m_cfg.enablePixelGaps) {
-              pos_hit_global =  m_cellid_converter->position(id);
-              pos_pixel = get_sensor_local_position(id, pos_hit_global);
-              pos_hit   = get_sensor_local_position(id, vec2pos(sim_hit.getPosition()));
+              auto pixel = m_PixelLookup(id);
+              if(pixel != nullptr) {
+                pos_hit_global = pixel->global_position;
+                pos_pixel      = pixel->local_position;
+                pos_hit        = pixel->sensor->ToLocal(vec2pos(sim_hit.getPosition()));
+              }
+              else {
+                pos_hit_global = m_cellid_converter->position(id);
+                pos_pixel      = get_sensor_local_position(id, pos_hit_global);
+                pos_hit        = get_sensor_local_position(id, vec2pos(sim_hit.getPosition()));
+              }
               if( std::abs( pos_hit.x()/dd4hep::mm - pos_pixel.x()/dd4hep::mm ) > m_cfg.pixelSize/2 ||
                   std::abs( pos_hit.y()/dd4hep::mm - pos_pixel.y()/dd4hep::mm ) > m_cfg.pixelSize/2
                 ) continue;
@@ -109,90 +113,103 @@ eicrecon::PhotoMultiplierHitDigiResult eicrecon::PhotoMultiplierHitDigi::Algorit
             auto   time = sim_hit.getTime();
             double amp  = m_cfg.speMean + m_rngNorm() * m_cfg.speError;
 
-            // insert hit to `hit_groups`
-            InsertHit(
-                hit_groups,
-                id,
-                amp,
-                time,
-                pos_hit,
-                pos_hit_global,
-                sim_hit_index
-                );
-        }
-
-        // print `hit_groups`
-        if(m_log->level() <= spdlog::level::trace) {
-          m_log->trace("{:-<70}","Accepted hit groups ");
-          for(auto &[id,hitVec] : hit_groups)
-            for(auto &hit : hitVec) {
-              m_log->trace("hit_group: pixel id={:#018X} -> npe={} signal={} time={}", id, hit.npe, hit.signal, hit.time);
-              for(auto i : hit.sim_hit_indices)
-                m_log->trace(" - MC hit: EDep={}, id={}", sim_hits->at(i).getEDep(), sim_hits->at(i).id());
-            }
+            m_pixel_hits.push_back({id, time, amp, pos_hit, pos_hit_global, sim_hit_index, false});
         }
+        std::sort(m_pixel_hits.begin(), m_pixel_hits.end(), PixelHitOrder);
 
-        //build noise raw hits
+        // merge noise hits into the sorted list
         if (m_cfg.enableNoise) {
           m_log->trace("{:=^70}"," BEGIN NOISE INJECTION ");
-          float p = m_cfg.noiseRate*m_cfg.noiseTimeWindow;
-          auto cellID_action = [this,&hit_groups] (auto id) {
-
-            // cell time, signal amplitude
-            double   amp  = m_cfg.speMean + m_rngNorm()*m_cfg.speError;
-            TimeType time = m_cfg.noiseTimeWindow*m_rngUni() / dd4hep::ns;
-            dd4hep::Position pos_hit_global = m_cellid_converter->position(id);
-
-            // insert in `hit_groups`, or if the pixel already has a hit, update `npe` and `signal`
-            this->InsertHit(
-                hit_groups,
-                id,
-                amp,
-                time,
-                dd4hep::Position{0,0,0}, // not used
-                pos_hit_global,
-                0, // not used
-                true
-                );
-
-          };
-          m_VisitRngCellIDs(cellID_action, p);
+          GenerateNoise(m_noise_hits);
+          auto num_signal_hits = m_pixel_hits.size();
+          m_pixel_hits.insert(m_pixel_hits.end(), m_noise_hits.begin(), m_noise_hits.end());
+          std::inplace_merge(m_pixel_hits.begin(), m_pixel_hits.begin() + num_signal_hits, m_pixel_hits.end(), PixelHitOrder);
         }
 
+        // group hits on the same pixel within `hitTimeWindow`; `m_pixel_hits` is already sorted
+        m_hit_merger.Clear();
+        m_hit_merger.Reserve(m_pixel_hits.size());
+        for(const auto& hit : m_pixel_hits)
+            m_hit_merger.Add(hit.id, hit.time, hit.amp);
+        m_hit_merger.Merge(m_cfg.hitTimeWindow, true);
+        const auto& hit_order = m_hit_merger.GetOrder();
+
         // build output `RawTrackerHit` and `MCRecoTrackerHitAssociation` collections
         m_log->trace("{:-<70}","Digitized raw hits ");
         PhotoMultiplierHitDigiResult result;
         result.raw_hits   = std::make_unique<edm4eic::RawTrackerHitCollection>();
         result.hit_assocs = std::make_unique<edm4eic::MCRecoTrackerHitAssociationCollection>();
-        for (auto &it : hit_groups) {
-            for (auto &data : it.second) {
-
-                // build `RawTrackerHit`
-                auto raw_hit = result.raw_hits->create();
-                raw_hit.setCellID(it.first);
-                raw_hit.setCharge(    static_cast<decltype(edm4eic::RawTrackerHitData::charge)>    (data.signal)                    );
-                raw_hit.setTimeStamp( static_cast<decltype(edm4eic::RawTrackerHitData::timeStamp)> (data.time/m_cfg.timeResolution) );
-                // raw_hit.setPosition(pos2vec(data.pos)) // TEST gap cuts; FIXME: requires member `edm4hep::Vector3d position`
-                                                          // in data model datatype, think of a better way
-                m_log->trace("raw_hit: cellID={:#018X} -> charge={} timeStamp={}",
-                    raw_hit.getCellID(),
-                    raw_hit.getCharge(),
-                    raw_hit.getTimeStamp()
-                    );
-
-                // build `MCRecoTrackerHitAssociation` (for non-noise hits only)
-                if(!data.sim_hit_indices.empty()) {
-                  auto hit_assoc = result.hit_assocs->create();
-                  hit_assoc.setWeight(1.0); // not used
-                  hit_assoc.setRawHit(raw_hit);
-                  for(auto i : data.sim_hit_indices)
-                    hit_assoc.addToSimHits(sim_hits->at(i));
+        for (const auto& group : m_hit_merger.GetGroups()) {
+
+            // signal: sum of amplitudes, plus pedestal
+            auto signal = group.charge + m_cfg.pedMean + m_cfg.pedError * m_rngNorm();
+            m_log->trace("hit_group: pixel id={:#018X} -> npe={} signal={} time={}", group.cellID, group.size(), signal, group.time);
+
+            // build `RawTrackerHit`
+            auto raw_hit = result.raw_hits->create();
+            raw_hit.setCellID(group.cellID);
+            raw_hit.setCharge(    static_cast<decltype(edm4eic::RawTrackerHitData::charge)>    (signal)                          );
+            raw_hit.setTimeStamp( static_cast<decltype(edm4eic::RawTrackerHitData::timeStamp)> (group.time/m_cfg.timeResolution) );
+            // raw_hit.setPosition(pos2vec(data.pos)) // TEST gap cuts; FIXME: requires member `edm4hep::Vector3d position`
+                                                      // in data model datatype, think of a better way
+            m_log->trace("raw_hit: cellID={:#018X} -> charge={} timeStamp={}",
+                raw_hit.getCellID(),
+                raw_hit.getCharge(),
+                raw_hit.getTimeStamp()
+                );
+
+            // build `MCRecoTrackerHitAssociation` (for non-noise hits only)
+            std::optional<edm4eic::MutableMCRecoTrackerHitAssociation> hit_assoc;
+            for (auto i = group.begin; i < group.end; i++) {
+                const auto& hit = m_pixel_hits[hit_order[i]];
+                if(hit.is_noise) continue;
+                if(!hit_assoc) {
+                  hit_assoc = result.hit_assocs->create();
+                  hit_assoc->setWeight(1.0); // not used
+                  hit_assoc->setRawHit(raw_hit);
                 }
+                hit_assoc->addToSimHits(sim_hits->at(hit.sim_hit_index));
+                m_log->trace(" - MC hit: EDep={}, id={}", sim_hits->at(hit.sim_hit_index).getEDep(), sim_hits->at(hit.sim_hit_index).id());
             }
         }
         return result;
 }
 
+void  eicrecon::PhotoMultiplierHitDigi::GenerateNoise(std::vector<PixelHit>& noise_hits)
+{
+        noise_hits.clear();
+        float p = m_cfg.noiseRate*m_cfg.noiseTimeWindow;
+
+        // noise hit with signal amplitude; `pos_local` and `sim_hit_index` are not used
+        auto add_noise_hit = [this,&noise_hits] (CellIDType id, dd4hep::Position pos_hit_global, double rand_time) {
+            double   amp  = m_cfg.speMean + m_rngNorm()*m_cfg.speError;
+            TimeType time = m_cfg.noiseTimeWindow*rand_time / dd4hep::ns;
+            noise_hits.push_back({id, time, amp, dd4hep::Position{0,0,0}, pos_hit_global, 0, true});
+        };
+
+        if (m_NumNoisePixels > 0) {
+            // number of noise hits, then pixel and time of each, with random numbers drawn in bulk
+            auto num_noise_hits = static_cast<std::size_t>(m_random.Poisson(p * m_NumNoisePixels));
+            m_noise_rand.resize(2 * num_noise_hits);
+            if (num_noise_hits > 0) m_random.RndmArray(static_cast<Int_t>(m_noise_rand.size()), m_noise_rand.data());
+            noise_hits.reserve(num_noise_hits);
+            for (std::size_t i = 0; i < num_noise_hits; i++) {
+                auto index = std::min(static_cast<std::size_t>(m_noise_rand[2*i] * m_NumNoisePixels), m_NumNoisePixels - 1);
+                const auto& pixel = m_NoisePixel(index);
+                add_noise_hit(pixel.cellID, pixel.global_position, m_noise_rand[2*i+1]);
+            }
+        }
+        else {
+            m_VisitRngCellIDs([this,&add_noise_hit] (CellIDType id) {
+                auto pixel = m_PixelLookup(id);
+                add_noise_hit(id, pixel != nullptr ? pixel->global_position : m_cellid_converter->position(id), m_rngUni());
+            }, p);
+        }
+
+        std::sort(noise_hits.begin(), noise_hits.end(), PixelHitOrder);
+        m_log->trace("generated {} noise hits", noise_hits.size());
+}
+
 void  eicrecon::PhotoMultiplierHitDigi::qe_init()
 {
         // get quantum efficiency table
@@ -225,55 +242,32 @@ void  eicrecon::PhotoMultiplierHitDigi::qe_init()
         if (qeff.back().first < 3.0) {
             m_log->warn("Quantum efficiency data end at {:.2f} {}", qeff.back().first, " eV, maybe you are using wrong units?");
         }
+
+        // uniform grid, for O(1) lookup
+        qe_table = UniformGridTable(qeff, qe_num_bins);
 }
 
 
-template<class RndmIter, typename T, class Compare> RndmIter  eicrecon::PhotoMultiplierHitDigi::interval_search(RndmIter beg, RndmIter end, const T &val, Compare comp) const
+void  eicrecon::PhotoMultiplierHitDigi::qe_pass_all(const edm4hep::SimTrackerHitCollection* sim_hits)
 {
-        // special cases
-        auto dist = std::distance(beg, end);
-        if ((dist < 2) || (comp(*beg, val) > 0) || (comp(*std::prev(end), val) < 0)) {
-            return end;
-        }
-        auto mid = std::next(beg, dist / 2);
-
-        while (mid != end) {
-            if (comp(*mid, val) == 0) {
-                return mid;
-            } else if (comp(*mid, val) > 0) {
-                end = mid;
-            } else {
-                beg = std::next(mid);
-            }
-            mid = std::next(beg, std::distance(beg, end)/2);
-        }
+        auto n = sim_hits->size();
 
-        if (mid == end || comp(*mid, val) > 0) {
-            return std::prev(mid);
+        // detection probability; energies out of QE data range are assumed to have 0% efficiency
+        qe_prob.resize(n);
+        for (std::size_t i = 0; i < n; i++) {
+            auto edep_eV = (*sim_hits)[i].getEDep() * 1e9; // [GeV] -> [eV] // FIXME: use common unit converters, when available
+            qe_prob[i] = m_cfg.safetyFactor * qe_table.Evaluate(edep_eV);
         }
-        return mid;
-}
 
-bool  eicrecon::PhotoMultiplierHitDigi::qe_pass(double ev, double rand) const
-{
-        auto it = interval_search(qeff.begin(), qeff.end(), ev,
-                    [] (const std::pair<double, double> &vals, double val) {
-                        return vals.first - val;
-                    });
-
-        if (it == qeff.end()) {
-            // m_log->warn("{} eV is out of QE data range, assuming 0\% efficiency",ev);
-            return false;
-        }
+        // one uniform random number per photon, drawn in bulk
+        qe_rand.resize(n);
+        if (n > 0) m_random.RndmArray(static_cast<Int_t>(n), qe_rand.data());
 
-        double prob = it->second;
-        auto itn = std::next(it);
-        if (itn != qeff.end() && (itn->first - it->first != 0)) {
-            prob = (it->second*(itn->first - ev) + itn->second*(ev - it->first)) / (itn->first - it->first);
+        qe_accepted.clear();
+        for (std::size_t i = 0; i < n; i++) {
+            if (qe_rand[i] <= qe_prob[i]) qe_accepted.push_back(i);
         }
-
-        // m_log->trace("{} eV, QE: {}\%",ev,prob*100.);
-        return rand <= prob;
+        m_log->trace("{} of {} photons pass quantum efficiency and safety factor", qe_accepted.size(), n);
 }
 
 
@@ -328,47 +322,3 @@ dd4hep::Position eicrecon::PhotoMultiplierHitDigi::get_sensor_local_position(uin
 
   return pos_transformed;
 }
-
-
-// add a hit to local `hit_groups` data structure
-void eicrecon::PhotoMultiplierHitDigi::InsertHit(
-    std::unordered_map<CellIDType, std::vector<HitData>> &hit_groups,
-    CellIDType       id,
-    double           amp,
-    TimeType         time,
-    dd4hep::Position pos_hit_local,
-    dd4hep::Position pos_hit_global,
-    std::size_t      sim_hit_index,
-    bool             is_noise_hit
-    )
-{
-  auto it = hit_groups.find(id);
-  if (it != hit_groups.end()) {
-    std::size_t i = 0;
-    for (auto ghit = it->second.begin(); ghit != it->second.end(); ++ghit, ++i) {
-      if (std::abs(time - ghit->time) <= (m_cfg.hitTimeWindow)) {
-        // hit group found, update npe, signal, and list of MC hits
-        ghit->npe += 1;
-        ghit->signal += amp;
-        if(!is_noise_hit) ghit->sim_hit_indices.push_back(sim_hit_index);
-        m_log->trace(" -> add to group @ {:#018X}: signal={}", id, ghit->signal);
-        break;
-      }
-    }
-    // no hits group found
-    if (i >= it->second.size()) {
-      auto sig = amp + m_cfg.pedMean + m_cfg.pedError * m_rngNorm();
-      decltype(HitData::sim_hit_indices) indices;
-      if(!is_noise_hit) indices.push_back(sim_hit_index);
-      hit_groups.insert({ id, {HitData{1, sig, time, pos_hit_local, pos_hit_global, indices}} });
-      m_log->trace(" -> no group found,");
-      m_log->trace("    so new group @ {:#018X}: signal={}", id, sig);
-    }
-  } else {
-    auto sig = amp + m_cfg.pedMean + m_cfg.pedError * m_rngNorm();
-    decltype(HitData::sim_hit_indices) indices;
-    if(!is_noise_hit) indices.push_back(sim_hit_index);
-    hit_groups.insert({ id, {HitData{1, sig, time, pos_hit_local, pos_hit_global, indices}} });
-    m_log->trace(" -> new group @ {:#018X}: signal={}", id, sig);
-  }
-}
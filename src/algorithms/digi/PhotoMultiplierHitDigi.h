@@ -16,17 +16,22 @@
 #pragma once
 
 #include "services/geometry/dd4hep/JDD4hep_service.h"
+#include "services/geometry/richgeo/ReadoutGeo.h"
 #include <TRandomGen.h>
 #include <edm4hep/SimTrackerHitCollection.h>
 #include <edm4eic/RawTrackerHitCollection.h>
 #include <edm4eic/MCRecoTrackerHitAssociationCollection.h>
 #include <spdlog/spdlog.h>
 #include <Evaluator/DD4hepUnits.h>
+#include <algorithm>
 #include <cstddef>
 #include <functional>
+#include <optional>
 
+#include "HitTimeWindowMerger.h"
 #include "PhotoMultiplierHitDigiConfig.h"
 #include "algorithms/interfaces/WithPodConfig.h"
+#include "algorithms/pid/Tools.h"
 
 namespace eicrecon {
 
@@ -50,16 +55,6 @@ public:
     using CellIDType = decltype(edm4hep::SimTrackerHitData::cellID);
     using TimeType   = decltype(edm4hep::SimTrackerHitData::time);
 
-    // local structure to hold data for a hit
-    struct HitData {
-      uint32_t                 npe;
-      double                   signal;
-      TimeType                 time;
-      dd4hep::Position         pos_local;
-      dd4hep::Position         pos_global;
-      std::vector<std::size_t> sim_hit_indices;
-    };
-
     // transform global position `pos` to sensor `id` frame position
     // IMPORTANT NOTE: this has only been tested for the dRICH; if you use it, test it carefully...
     dd4hep::Position get_sensor_local_position(CellIDType id, dd4hep::Position pos);
@@ -86,25 +81,63 @@ public:
         )
     { m_VisitRngCellIDs = visitor; }
 
+    // set `m_PixelLookup`, which returns the precomputed geometry of the pixel
+    // with a given CellID, or nullptr if there is none; if set, per-hit DD4hep
+    // geometry calls are avoided
+    void SetPixelLookup(
+        std::function< const richgeo::ReadoutGeo::Pixel*(CellIDType) > lookup
+        )
+    { m_PixelLookup = lookup; }
+
+    // set the table of `num_pixels` pixels from which noise hits are drawn, where
+    // `pixel(i)` returns the i-th pixel; if set, noise is generated from this table
+    // instead of with `m_VisitRngCellIDs`
+    void SetNoisePixels(
+        std::size_t num_pixels,
+        std::function< const richgeo::ReadoutGeo::Pixel&(std::size_t) > pixel
+        )
+    { m_NumNoisePixels = num_pixels; m_NoisePixel = pixel; }
+
 protected:
 
     // visitor of all possible CellIDs (set with SetVisitRngCellIDs)
     std::function< void(std::function<void(CellIDType)>, float) > m_VisitRngCellIDs =
       [] ( std::function<void(CellIDType)> visitor_action, float p ) { /* default no-op */ };
 
+    // precomputed pixel geometry lookup (set with SetPixelLookup)
+    std::function< const richgeo::ReadoutGeo::Pixel*(CellIDType) > m_PixelLookup =
+      [] ( CellIDType id ) -> const richgeo::ReadoutGeo::Pixel* { return nullptr; };
+
+    // noise pixel table (set with SetNoisePixels)
+    std::size_t m_NumNoisePixels = 0;
+    std::function< const richgeo::ReadoutGeo::Pixel&(std::size_t) > m_NoisePixel;
+
 private:
 
-    // add a hit to local `hit_groups` data structure
-    void InsertHit(
-        std::unordered_map<CellIDType, std::vector<HitData>> &hit_groups,
-        CellIDType       id,
-        double           amp,
-        TimeType         time,
-        dd4hep::Position pos_hit_local,
-        dd4hep::Position pos_hit_global,
-        std::size_t      sim_hit_index,
-        bool             is_noise_hit = false
-        );
+    // a detected photon or noise hit, before grouping by pixel and time
+    struct PixelHit {
+      CellIDType       id;
+      TimeType         time;
+      double           amp;
+      dd4hep::Position pos_local;
+      dd4hep::Position pos_global;
+      std::size_t      sim_hit_index;
+      bool             is_noise;
+    };
+    static bool PixelHitOrder(const PixelHit& a, const PixelHit& b) {
+      return a.id < b.id || (a.id == b.id && a.time < b.time);
+    }
+
+    // generate dark-noise hits, sorted by `PixelHitOrder`: the number of hits is
+    // Poisson distributed, and their pixels are drawn from the noise pixel table
+    void GenerateNoise(std::vector<PixelHit>& noise_hits);
+
+    std::vector<PixelHit> m_pixel_hits; // per-event buffers
+    std::vector<PixelHit> m_noise_hits;
+    std::vector<double>   m_noise_rand;
+
+    // grouping of hits on the same pixel within `hitTimeWindow`
+    HitTimeWindowMerger m_hit_merger;
 
     dd4hep::Detector *m_detector   = nullptr;
 
@@ -115,8 +148,14 @@ private:
     // std::normal_distribution<double> m_normDist; // defaults to mean=0, sigma=1
 
     std::vector<std::pair<double, double>> qeff;
+    UniformGridTable qe_table; // QE vs. energy [eV], built from `qeff`
+    static constexpr unsigned qe_num_bins = 1000;
     void qe_init();
-    template<class RndmIter, typename T, class Compare> RndmIter interval_search(RndmIter beg, RndmIter end, const T &val, Compare comp) const;
-    bool qe_pass(double ev, double rand) const;
+    // apply the quantum efficiency and the safety factor to all `sim_hits` in one pass, with
+    // bulk-generated random numbers; fills `qe_accepted` with the indices of accepted hits
+    void qe_pass_all(const edm4hep::SimTrackerHitCollection* sim_hits);
+    std::vector<double>      qe_prob;     // per-event buffers
+    std::vector<double>      qe_rand;
+    std::vector<std::size_t> qe_accepted;
 };
 }
@@ -4,26 +4,25 @@
 
 #include <spdlog/spdlog.h>
 
-#include "algorithms/interfaces/ICollectionProducer.h"
-
 #include <edm4hep/SimTrackerHit.h>
-#include <edm4eic/RawTrackerHit.h>
+#include <edm4eic/RawTrackerHitCollection.h>
 #include <TRandomGen.h>
 
+#include "HitTimeWindowMerger.h"
 #include "SiliconTrackerDigiConfig.h"
 
 namespace eicrecon {
 
     /** digitization algorithm for a silicon trackers **/
-    class SiliconTrackerDigi:ICollectionProducer<edm4hep::SimTrackerHit, edm4eic::RawTrackerHit> {
+    class SiliconTrackerDigi {
     public:
         SiliconTrackerDigi() = default;
 
         /// Initialization function is called once (probably from corresponding factories)
         void init(std::shared_ptr<spdlog::logger>& logger);
 
-        /// ICollectionProducer processes RawTrackerHit collection from SimTrackerHit
-        virtual std::vector<edm4eic::RawTrackerHit*> produce(const std::vector<const edm4hep::SimTrackerHit *>& sim_hits);
+        /// Produces RawTrackerHit collection from SimTrackerHits, merging hits on the same cell
+        std::unique_ptr<edm4eic::RawTrackerHitCollection> produce(const std::vector<const edm4hep::SimTrackerHit *>& sim_hits);
 
         /// Get a configuration to be changed
         eicrecon::SiliconTrackerDigiConfig& getConfig() {return m_cfg;}
@@ -42,6 +41,9 @@ namespace eicrecon {
         TRandomMixMax m_random;
         std::function<double()> m_gauss;
 
+        /** Merging of hits on the same cell */
+        HitTimeWindowMerger m_hit_merger;
+
     };
 
 } // eicrecon
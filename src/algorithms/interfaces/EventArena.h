@@ -0,0 +1,111 @@
+// Copyright 2023, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace eicrecon {
+
+    /**
+     * Per-thread arena for the scratch containers of algorithms
+     *
+     * Allocations from the arena bump a pointer in a buffer of the calling thread, so
+     * they take no locks and do not fragment the global heap. They are all freed at
+     * once when the outermost Scope of the thread ends, i.e. at the end of each
+     * algorithm call, so at least once per event. The buffer grows to what the calls
+     * of the thread needed (up to kMaxBufferSize), so that later events usually need
+     * no allocations from the global heap at all.
+     *
+     * Only use it for containers that live during the call, never for output
+     * collections or for anything kept by the algorithm:
+     *
+     *    std::unique_ptr<...> MyAlgorithm::process(...) {
+     *        EventArena::Scope arena_scope;
+     *        EventArena::vector<std::size_t> indices(EventArena::resource());
+     *        ...
+     */
+    class EventArena {
+    public:
+        template <typename T>
+        using vector = std::pmr::vector<T>;
+
+        template <typename Key, typename T, typename Compare = std::less<Key>>
+        using map = std::pmr::map<Key, T, Compare>;
+
+        template <typename Key, typename T, typename Hash = std::hash<Key>>
+        using unordered_map = std::pmr::unordered_map<Key, T, Hash>;
+
+        static constexpr std::size_t kInitialBufferSize = 64 * 1024;
+        static constexpr std::size_t kMaxBufferSize     = 8 * 1024 * 1024;
+
+        /// Memory resource of the arena of the calling thread
+        static std::pmr::memory_resource* resource() { return threadArena().resource(); }
+
+        /// Lifetime of arena allocations; the arena is reset when the outermost scope of the thread ends
+        class Scope {
+        public:
+            Scope() { threadArena().enter(); }
+            ~Scope() { threadArena().leave(); }
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+        };
+
+    private:
+
+        /// Global heap, counting what the arena needs beyond its buffer
+        class Upstream : public std::pmr::memory_resource {
+        public:
+            std::size_t allocated = 0;
+
+        private:
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                allocated += bytes;
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+                std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+            }
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+
+        class Arena {
+        public:
+            Arena(): m_buffer(kInitialBufferSize) { reset(); }
+
+            std::pmr::memory_resource* resource() { return &*m_resource; }
+            void enter() { m_depth++; }
+            void leave() { if (--m_depth == 0) reset(); }
+
+        private:
+            void reset() {
+                m_resource.reset();   // returns the overflow to the global heap
+                if (m_upstream.allocated > 0 && m_buffer.size() < kMaxBufferSize) {
+                    m_buffer.resize(std::min(kMaxBufferSize, m_buffer.size() + m_upstream.allocated));
+                }
+                m_upstream.allocated = 0;
+                m_resource.emplace(m_buffer.data(), m_buffer.size(), &m_upstream);
+            }
+
+            std::vector<std::byte> m_buffer;
+            Upstream m_upstream;
+            std::optional<std::pmr::monotonic_buffer_resource> m_resource;
+            std::size_t m_depth = 0;
+        };
+
+        static Arena& threadArena() {
+            thread_local Arena arena;
+            return arena;
+        }
+    };
+
+} // eicrecon
@@ -3,6 +3,11 @@
 
 #include "IrtCherenkovParticleID.h"
 
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <set>
+
 // AlgorithmInit
 //---------------------------------------------------------------------------
 void eicrecon::IrtCherenkovParticleID::AlgorithmInit(
@@ -36,13 +41,21 @@ void eicrecon::IrtCherenkovParticleID::AlgorithmInit(
   m_log->debug("readout cellMask = {:#X}", m_cell_mask);
 
   // rebin refractive index tables to have `m_cfg.numRIndexBins` bins
-  m_log->trace("Rebinning refractive index tables to have {} bins",m_cfg.numRIndexBins);
-  for(auto [rad_name,irt_rad] : m_irt_det->Radiators()) {
-    auto ri_lookup_table_orig = irt_rad->m_ri_lookup_table;
-    irt_rad->m_ri_lookup_table.clear();
-    irt_rad->m_ri_lookup_table = Tools::ApplyFineBinning( ri_lookup_table_orig, m_cfg.numRIndexBins );
-    // m_log->trace("- {}", rad_name);
-    // for(auto [energy,rindex] : irt_rad->m_ri_lookup_table) m_log->trace("  {:>5} eV   {:<}", energy, rindex);
+  // - the IRT radiators are shared by all instances of this algorithm, so only rebin them once
+  // - build a `UniformGridTable` from each, for O(1) lookup
+  {
+    static std::mutex rebin_mutex;
+    static std::set<const CherenkovRadiator*> rebinned_radiators;
+    std::lock_guard<std::mutex> lock(rebin_mutex);
+    for(auto [rad_name,irt_rad] : m_irt_det->Radiators()) {
+      if(rebinned_radiators.insert(irt_rad).second) {
+        m_log->trace("Rebinning refractive index table of '{}' to have {} bins", rad_name, m_cfg.numRIndexBins);
+        auto ri_lookup_table_orig = irt_rad->m_ri_lookup_table;
+        irt_rad->m_ri_lookup_table.clear();
+        irt_rad->m_ri_lookup_table = Tools::ApplyFineBinning( ri_lookup_table_orig, m_cfg.numRIndexBins );
+      }
+      m_rindex_tables.insert({ irt_rad, UniformGridTable(irt_rad->m_ri_lookup_table, m_cfg.numRIndexBins) });
+    }
   }
 
   // build `m_pid_radiators`, the list of radiators to use for PID
@@ -79,6 +92,29 @@ void eicrecon::IrtCherenkovParticleID::AlgorithmInit(
       m_log->error("Cannot find radiator '{}' in IrtCherenkovParticleIDConfig instance", rad_name);
   }
 
+  // fiducial cut: maximum Cherenkov angle of each radiator, and focusing mirror centers
+  for(auto [rad_name,irt_rad] : m_pid_radiators) {
+    auto cfg_rad_it = m_cfg.radiators.find(rad_name);
+    double rindex   = cfg_rad_it != m_cfg.radiators.end() ? cfg_rad_it->second.referenceRIndex : 1.0;
+    m_max_cherenkov_angle.insert({ rad_name, rindex > 1.0 ? std::acos(1.0/rindex) : 0.0 });
+    for(auto [isec,borders] : irt_rad->m_Borders) {
+      auto mirror = dynamic_cast<const SphericalSurface*>(borders.second);
+      if(mirror == nullptr) continue;
+      auto center = mirror->GetCenter();
+      if(std::find(m_mirror_centers.begin(), m_mirror_centers.end(), center) == m_mirror_centers.end())
+        m_mirror_centers.push_back(center);
+    }
+  }
+  if(m_cfg.fiducialCut) {
+    m_log->debug("Fiducial cut:");
+    for(auto [rad_name,angle] : m_max_cherenkov_angle)
+      m_log->debug("  {:>10}: max Cherenkov angle = {:.4f} rad (+ {:.4f} rad margin)", rad_name, angle, m_cfg.fiducialMargin);
+    if(m_mirror_centers.empty())
+      m_log->debug("  no focusing mirrors found; rings are centered on the particle direction from the emission point");
+    for(const auto& center : m_mirror_centers)
+      Tools::PrintTVector3(m_log, "  mirror center", center, 30, spdlog::level::debug);
+  }
+
   // get PDG info for the particles we want to identify in PID
   // FIXME: cannot use `TDatabasePDG` since it is not thread safe; until we
   // have a proper PDG database service, we hard-code the masses in Tools.h
@@ -129,13 +165,22 @@ std::map<std::string, std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> e
     }
   }
 
+  // recycle the IRT objects of the previous event
+  m_particle_pool.Reset();
+  m_rad_history_pool.Reset();
+  m_photon_pool.Reset();
+
+  // cache sensor hit positions, and index them for the fiducial cut
+  BuildHitIndex(in_raw_hits);
+  BuildHitAssocIndex(in_raw_hits, in_hit_assocs);
+
   // loop over charged particles ********************************************
   m_log->trace("{:#<70}","### CHARGED PARTICLES ");
   for(long i_charged_particle=0; i_charged_particle<num_charged_particles; i_charged_particle++) {
     m_log->trace("{:-<70}", fmt::format("--- charged particle #{} ", i_charged_particle));
 
     // start an `irt_particle`, for `IRT`
-    auto irt_particle = std::make_unique<ChargedParticle>();
+    auto irt_particle = m_particle_pool.Get();
 
     // loop over radiators
     for(auto [rad_name,irt_rad] : m_pid_radiators) {
@@ -148,6 +193,8 @@ std::map<std::string, std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> e
       }
       auto charged_particle_list = charged_particle_list_it->second;
       auto charged_particle      = charged_particle_list->at(i_charged_particle);
+      auto& photon_raw_hits      = m_photon_raw_hits[rad_name];
+      photon_raw_hits.clear();
 
       // set number of bins for this radiator and charged particle
       if(charged_particle.points_size()==0) {
@@ -158,10 +205,13 @@ std::map<std::string, std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> e
 
       // start a new IRT `RadiatorHistory`
       // - must be a raw pointer for `irt` compatibility
-      // - it will be destroyed when `irt_particle` is destroyed
-      auto irt_rad_history = new RadiatorHistory();
+      // - it is owned by `m_rad_history_pool`
+      auto irt_rad_history = m_rad_history_pool.Get();
       irt_particle->StartRadiatorHistory({ irt_rad, irt_rad_history });
 
+      // refractive index table, for cheat mode
+      const auto& rindex_table = m_rindex_tables.at(irt_rad);
+
       // loop over `TrackPoint`s of this `charged_particle`, adding each to the IRT radiator
       irt_rad->ResetLocations();
       m_log->trace("TrackPoints in '{}' radiator:", rad_name);
@@ -175,32 +225,32 @@ std::map<std::string, std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> e
 
 
       // loop over raw hits ***************************************************
+      const auto& fiducial_hits = SelectFiducialHits(charged_particle, rad_name);
       m_log->trace("{:#<70}","### SENSOR HITS ");
-      for(const auto& raw_hit : *in_raw_hits) {
+      m_log->trace("{} of {} raw hits within fiducial region", fiducial_hits.size(), in_raw_hits->size());
+      for(auto i_raw_hit : fiducial_hits) {
+        auto raw_hit = (*in_raw_hits)[i_raw_hit];
 
         // get MC photon(s), typically only used by cheat modes or trace logging
-        // - loop over `in_hit_assocs`, searching for the matching hit association
+        // - look up the matching hit association
         // - will not exist for noise hits
         edm4hep::MCParticle mc_photon;
         bool mc_photon_found = false;
         if(m_cfg.cheatPhotonVertex || m_cfg.cheatTrueRadiator) {
-          for(const auto& hit_assoc : *in_hit_assocs) {
-            if(hit_assoc.getRawHit().isAvailable()) {
-              if(hit_assoc.getRawHit().id() == raw_hit.id()) {
-                // hit association found, get the MC photon and break the loop
-                // FIXME: occasionally there will be more than one photon associated with a hit;
-                // for now let's just take the first one...
-                if(hit_assoc.simHits_size() > 0) {
-                  mc_photon = hit_assoc.getSimHits(0).getMCParticle();
-                  mc_photon_found = true;
-                  if(mc_photon.getPDG() != -22)
-                    m_log->warn("non-opticalphoton hit: PDG = {}",mc_photon.getPDG());
-                }
-                else if(m_cfg.CheatModeEnabled())
-                  m_log->error("cheat mode enabled, but no MC photons provided");
-                break;
-              }
+          auto i_hit_assoc = m_hit_assoc_index[i_raw_hit];
+          if(i_hit_assoc >= 0) {
+            // hit association found, get the MC photon
+            // FIXME: occasionally there will be more than one photon associated with a hit;
+            // for now let's just take the first one...
+            auto hit_assoc = (*in_hit_assocs)[i_hit_assoc];
+            if(hit_assoc.simHits_size() > 0) {
+              mc_photon = hit_assoc.getSimHits(0).getMCParticle();
+              mc_photon_found = true;
+              if(mc_photon.getPDG() != -22)
+                m_log->warn("non-opticalphoton hit: PDG = {}",mc_photon.getPDG());
             }
+            else if(m_cfg.CheatModeEnabled())
+              m_log->error("cheat mode enabled, but no MC photons provided");
           }
         }
 
@@ -216,7 +266,7 @@ std::map<std::string, std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> e
         // FIXME: signal and timing cuts (ADC, TDC, ToT, ...)
         auto     cell_id   = raw_hit.getCellID();
         uint64_t sensor_id = cell_id & m_cell_mask;
-        TVector3 pixel_pos = m_irt_det->m_ReadoutIDToPosition(cell_id);
+        TVector3 pixel_pos = m_hit_pos[i_raw_hit];
 
         // trace logging
         if(m_log->level() <= spdlog::level::trace) {
@@ -232,7 +282,7 @@ std::map<std::string, std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> e
 
         // start new IRT photon
         auto irt_sensor = m_irt_det->m_PhotonDetectors[0]; // NOTE: assumes one sensor type
-        auto irt_photon = new OpticalPhoton(); // new raw pointer; it will also be destroyed when `irt_particle` is destroyed
+        auto irt_photon = m_photon_pool.Get(); // raw pointer, owned by `m_photon_pool`
         irt_photon->SetVolumeCopy(sensor_id);
         irt_photon->SetDetectionPosition(pixel_pos);
         irt_photon->SetPhotonDetector(irt_sensor);
@@ -248,11 +298,7 @@ std::map<std::string, std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> e
         // was used in GEANT, but should be very close
         if(m_cfg.cheatPhotonVertex) {
           double ri;
-          auto ri_set = Tools::GetFinelyBinnedTableEntry(
-              irt_rad->m_ri_lookup_table,
-              1e9 * irt_photon->GetVertexMomentum().Mag(),
-              &ri
-              );
+          auto ri_set = rindex_table.Interpolate(1e9 * irt_photon->GetVertexMomentum().Mag(), &ri);
           if(ri_set) irt_photon->SetVertexRefractiveIndex(ri);
         }
 
@@ -261,12 +307,8 @@ std::map<std::string, std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> e
         // radiator, thus we add them all to each radiator; the radiators'
         // photons are mixed in `ChargedParticle::PIDReconstruction`
         irt_rad_history->AddOpticalPhoton(irt_photon);
-        /* FIXME: this considers ALL of the `irt_photon`s... we can limit this
-         * once we add the ability to get a fiducial volume for each track, i.e.,
-         * a region of sensors where we expect to see this `irt_particle`'s
-         * Cherenkov photons; this should also combat sensor noise
-         */
-      } // end `in_hit_assocs` loop
+        photon_raw_hits.push_back(i_raw_hit);
+      } // end `in_raw_hits` loop
 
     } // end radiator loop
 
@@ -296,6 +338,7 @@ std::map<std::string, std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> e
       double   rindex_ave = 0.0;
       double   energy_ave = 0.0;
       std::vector<std::pair<double,double>> phot_theta_phi;
+      std::vector<size_t> selected_raw_hits;
 
       // loop over this radiator's photons, and decide which to include in the theta estimate
       auto irt_rad_history = irt_particle->FindRadiatorHistory(irt_rad);
@@ -304,7 +347,10 @@ std::map<std::string, std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> e
         continue;
       }
       m_log->trace("  Photoelectrons:");
-      for(auto irt_photon : irt_rad_history->Photons()) {
+      const auto& photon_raw_hits = m_photon_raw_hits.at(rad_name);
+      const auto& irt_photons     = irt_rad_history->Photons();
+      for(size_t i_photon = 0; i_photon < irt_photons.size(); i_photon++) {
+        auto irt_photon = irt_photons[i_photon];
 
         // check whether this photon was selected by at least one mass hypothesis
         bool photon_selected = false;
@@ -331,6 +377,7 @@ std::map<std::string, std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> e
         // add to the total
         npe++;
         phot_theta_phi.emplace_back( phot_theta, phot_phi );
+        selected_raw_hits.push_back(photon_raw_hits[i_photon]);
         if(m_cfg.cheatPhotonVertex) {
           rindex_ave += irt_photon->GetVertexRefractiveIndex();
           energy_ave += irt_photon->GetVertexMomentum().Mag();
@@ -387,18 +434,159 @@ std::map<std::string, std::unique_ptr<edm4eic::CherenkovParticleIDCollection>> e
       else
         m_log->error("Cannot find radiator 'Merged' in `in_charged_particles`");
 
-      // relate hit associations
-      for(const auto& hit_assoc : *in_hit_assocs)
-        out_cherenkov_pid.addToRawHitAssociations(hit_assoc);
+      // relate hit associations of the photons which contributed to this estimate
+      for(auto i_raw_hit : selected_raw_hits) {
+        auto i_hit_assoc = m_hit_assoc_index[i_raw_hit];
+        if(i_hit_assoc >= 0)
+          out_cherenkov_pid.addToRawHitAssociations((*in_hit_assocs)[i_hit_assoc]);
+      }
 
     } // end radiator loop
 
-    /* NOTE: `unique_ptr irt_particle` goes out of scope and will now be destroyed, and along with it:
-     * - raw pointer `irt_rad_history` for each radiator
-     * - all `irt_photon` raw pointers
+    /* NOTE: `irt_particle`, its `irt_rad_history`s, and all `irt_photon`s are owned by the pools,
+     * and will be recycled in the next event
      */
 
   } // end `in_charged_particles` loop
 
   return result;
 }
+
+
+// BuildHitIndex
+//---------------------------------------------------------------------------
+void eicrecon::IrtCherenkovParticleID::BuildHitIndex(const edm4eic::RawTrackerHitCollection* in_raw_hits) {
+
+  // pixel positions
+  m_hit_pos.clear();
+  for(const auto& raw_hit : *in_raw_hits)
+    m_hit_pos.push_back(m_irt_det->m_ReadoutIDToPosition(raw_hit.getCellID()));
+  if(!m_cfg.fiducialCut || m_mirror_centers.empty()) return;
+
+  // directions from the mirror center of each hit's sector; the sector is the one of the nearest mirror in azimuth
+  m_hit_dir.clear();
+  m_hit_cell.clear();
+  for(const auto& pixel_pos : m_hit_pos) {
+    auto mirror_it = std::min_element(m_mirror_centers.begin(), m_mirror_centers.end(),
+        [&pixel_pos] (const TVector3& a, const TVector3& b) {
+          return std::abs(pixel_pos.DeltaPhi(a)) < std::abs(pixel_pos.DeltaPhi(b));
+        });
+    m_hit_dir.push_back((pixel_pos - *mirror_it).Unit());
+    m_hit_cell.push_back(GetGridCell(m_hit_dir.back()));
+  }
+
+  // counting sort of the hits into the (theta,phi) grid
+  m_grid_offsets.assign(m_grid_num_theta * m_grid_num_phi + 1, 0);
+  for(auto cell : m_hit_cell)
+    m_grid_offsets[cell+1]++;
+  std::partial_sum(m_grid_offsets.begin(), m_grid_offsets.end(), m_grid_offsets.begin());
+  m_grid_hits.resize(m_hit_cell.size());
+  for(size_t i_raw_hit = m_hit_cell.size(); i_raw_hit-- > 0; ) // backwards, so that each cell keeps the hits' order
+    m_grid_hits[--m_grid_offsets[m_hit_cell[i_raw_hit]+1]] = i_raw_hit;
+  // `m_grid_offsets[cell+1]` now points at the first hit of cell `cell`; shift back into place
+  std::rotate(m_grid_offsets.begin(), m_grid_offsets.begin()+1, m_grid_offsets.end());
+  m_grid_offsets.back() = m_grid_hits.size();
+}
+
+
+// SelectFiducialHits
+//---------------------------------------------------------------------------
+const std::vector<size_t>& eicrecon::IrtCherenkovParticleID::SelectFiducialHits(
+    const edm4eic::TrackSegment& charged_particle,
+    const std::string&           rad_name
+    )
+{
+  m_selected_hits.clear();
+
+  // particle direction and mean position in this radiator
+  TVector3 direction, emission_point;
+  for(const auto& point : charged_particle.getPoints()) {
+    direction      += Tools::PodioVector3_to_TVector3(point.momentum).Unit();
+    emission_point += Tools::PodioVector3_to_TVector3(point.position);
+  }
+
+  // without a cut, or without a direction, consider all the hits
+  if(!m_cfg.fiducialCut || direction.Mag2() == 0) {
+    m_selected_hits.resize(m_hit_pos.size());
+    std::iota(m_selected_hits.begin(), m_selected_hits.end(), 0);
+    return m_selected_hits;
+  }
+  direction      = direction.Unit();
+  emission_point = (1.0 / charged_particle.points_size()) * emission_point;
+  double cone     = std::min(m_max_cherenkov_angle.at(rad_name) + m_cfg.fiducialMargin, M_PI);
+  double cos_cone = std::cos(cone);
+
+  // proximity focusing: the ring is centered on the particle direction, seen from the emission point
+  if(m_mirror_centers.empty()) {
+    for(size_t i_raw_hit = 0; i_raw_hit < m_hit_pos.size(); i_raw_hit++)
+      if((m_hit_pos[i_raw_hit] - emission_point).Unit().Dot(direction) >= cos_cone)
+        m_selected_hits.push_back(i_raw_hit);
+    return m_selected_hits;
+  }
+
+  // mirror focusing: visit the grid cells overlapping with the cone around `direction`
+  // - theta range: cone half-angle around the particle's theta
+  // - phi range: a cone of half-angle `cone` spans at most asin(sin(cone)/sin(theta)) in phi, where
+  //   theta is the one closest to a pole within the theta range; use all phi if it includes a pole
+  double theta_min = direction.Theta() - cone;
+  double theta_max = direction.Theta() + cone;
+  int    ith_min   = std::max(0, static_cast<int>(std::floor(theta_min / m_grid_bin_size)));
+  int    ith_max   = std::min(m_grid_num_theta - 1, static_cast<int>(std::floor(theta_max / m_grid_bin_size)));
+  int    iph_half  = m_grid_num_phi;
+  if(theta_min > 0 && theta_max < M_PI && cone < M_PI_2) {
+    double sin_theta = std::min(std::sin(theta_min), std::sin(theta_max));
+    if(sin_theta > std::sin(cone))
+      iph_half = static_cast<int>(std::ceil(std::asin(std::sin(cone) / sin_theta) / m_grid_bin_size)) + 1;
+  }
+  int iph_center = GetGridCell(direction) % m_grid_num_phi;
+  int iph_min    = iph_center - iph_half;
+  int iph_max    = iph_center + iph_half;
+  if(iph_max - iph_min + 1 >= m_grid_num_phi) {
+    iph_min = 0;
+    iph_max = m_grid_num_phi - 1;
+  }
+  for(int ith = ith_min; ith <= ith_max; ith++) {
+    for(int iph = iph_min; iph <= iph_max; iph++) {
+      int cell = ith * m_grid_num_phi + (iph + m_grid_num_phi) % m_grid_num_phi;
+      for(auto i = m_grid_offsets[cell]; i < m_grid_offsets[cell+1]; i++) {
+        auto i_raw_hit = m_grid_hits[i];
+        if(m_hit_dir[i_raw_hit].Dot(direction) >= cos_cone)
+          m_selected_hits.push_back(i_raw_hit);
+      }
+    }
+  }
+
+  // keep the hits in their original order
+  std::sort(m_selected_hits.begin(), m_selected_hits.end());
+  return m_selected_hits;
+}
+
+
+// GetGridCell
+//---------------------------------------------------------------------------
+int eicrecon::IrtCherenkovParticleID::GetGridCell(const TVector3& direction) const {
+  int ith = std::min(m_grid_num_theta - 1, static_cast<int>(direction.Theta() / m_grid_bin_size));
+  int iph = std::min(m_grid_num_phi - 1,   static_cast<int>((direction.Phi() + M_PI) / m_grid_bin_size));
+  return ith * m_grid_num_phi + iph;
+}
+
+
+// BuildHitAssocIndex
+//---------------------------------------------------------------------------
+void eicrecon::IrtCherenkovParticleID::BuildHitAssocIndex(
+    const edm4eic::RawTrackerHitCollection*               in_raw_hits,
+    const edm4eic::MCRecoTrackerHitAssociationCollection* in_hit_assocs
+    )
+{
+  m_hit_assoc_lookup.clear();
+  for(size_t i_hit_assoc = 0; i_hit_assoc < in_hit_assocs->size(); i_hit_assoc++) {
+    auto raw_hit = (*in_hit_assocs)[i_hit_assoc].getRawHit();
+    if(raw_hit.isAvailable())
+      m_hit_assoc_lookup.insert({ raw_hit.id(), i_hit_assoc }); // keeps the first association of each raw hit
+  }
+  m_hit_assoc_index.clear();
+  for(const auto& raw_hit : *in_raw_hits) {
+    auto it = m_hit_assoc_lookup.find(raw_hit.id());
+    m_hit_assoc_index.push_back(it != m_hit_assoc_lookup.end() ? static_cast<long>(it->second) : -1);
+  }
+}
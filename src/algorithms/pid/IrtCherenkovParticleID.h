@@ -14,12 +14,14 @@
 #include <IRT/CherenkovRadiator.h>
 #include <IRT/CherenkovEvent.h>
 #include <IRT/CherenkovDetectorCollection.h>
+#include <IRT/ParametricSurface.h>
 
 // DD4hep
 #include <Evaluator/DD4hepUnits.h>
 
 // EICrecon
 #include "IrtCherenkovParticleIDConfig.h"
+#include "IrtObjectPool.h"
 #include "Tools.h"
 #include "algorithms/interfaces/WithPodConfig.h"
 #include <spdlog/spdlog.h>
@@ -53,6 +55,24 @@ namespace eicrecon {
 
     private:
 
+      // fiducial cut helpers
+      // - `BuildHitIndex` caches the pixel position of each raw hit; for mirror-focusing detectors, it
+      //   also sorts the hits into a (theta,phi) grid of their directions, as seen from the mirror center
+      // - `SelectFiducialHits` returns the (sorted) indices of the raw hits within the expected ring
+      //   footprint of `charged_particle` in radiator `rad_name`
+      void BuildHitIndex(const edm4eic::RawTrackerHitCollection* in_raw_hits);
+      const std::vector<size_t>& SelectFiducialHits(
+          const edm4eic::TrackSegment& charged_particle,
+          const std::string&           rad_name
+          );
+      int GetGridCell(const TVector3& direction) const;
+
+      // fill `m_hit_assoc_index`
+      void BuildHitAssocIndex(
+          const edm4eic::RawTrackerHitCollection*               in_raw_hits,
+          const edm4eic::MCRecoTrackerHitAssociationCollection* in_hit_assocs
+          );
+
       std::shared_ptr<spdlog::logger> m_log;
       CherenkovDetectorCollection*    m_irt_det_coll;
       CherenkovDetector*              m_irt_det;
@@ -61,6 +81,34 @@ namespace eicrecon {
       std::string m_det_name;
       std::unordered_map<int,double>           m_pdg_mass;
       std::map<std::string,CherenkovRadiator*> m_pid_radiators;
+      std::unordered_map<const CherenkovRadiator*,UniformGridTable> m_rindex_tables; // radiator -> refractive index vs. energy [eV]
+
+      // fiducial cut
+      // - a photon reflected by a spherical mirror lands (approximately) on the focal surface, at the point
+      //   seen from the mirror center under the photon direction; for proximity focusing detectors, the ring
+      //   is instead seen from the photon emission point
+      std::map<std::string,double> m_max_cherenkov_angle; // radiator name -> maximum Cherenkov angle [rad]
+      std::vector<TVector3>        m_mirror_centers;      // one per sector; empty for proximity focusing
+      static constexpr double      m_grid_bin_size = 0.05; // (theta,phi) grid bin size [rad]
+      static constexpr int         m_grid_num_theta = static_cast<int>(M_PI / m_grid_bin_size) + 1;
+      static constexpr int         m_grid_num_phi   = static_cast<int>(2 * M_PI / m_grid_bin_size) + 1;
+      // per-event buffers, reused to avoid reallocation
+      std::vector<TVector3> m_hit_pos;      // raw hit index -> pixel position
+      std::vector<TVector3> m_hit_dir;      // raw hit index -> unit direction from its sector's mirror center
+      std::vector<int>      m_hit_cell;     // raw hit index -> (theta,phi) grid cell
+      std::vector<size_t>   m_grid_offsets; // grid cell -> first entry in `m_grid_hits`
+      std::vector<size_t>   m_grid_hits;    // raw hit indices, sorted by grid cell
+      std::vector<size_t>   m_selected_hits;
+
+      // hit associations, per event
+      std::vector<long>                       m_hit_assoc_index;  // raw hit index -> hit association index, or -1 (e.g., noise hits)
+      std::unordered_map<unsigned int,size_t> m_hit_assoc_lookup; // raw hit ID -> hit association index
+      std::map<std::string,std::vector<size_t>> m_photon_raw_hits; // radiator name -> raw hit index of each photon in its `RadiatorHistory`
+
+      // IRT objects, recycled every event
+      IrtObjectPool<ChargedParticle> m_particle_pool;
+      IrtObjectPool<RadiatorHistory> m_rad_history_pool;
+      IrtObjectPool<OpticalPhoton>   m_photon_pool;
 
   };
 }
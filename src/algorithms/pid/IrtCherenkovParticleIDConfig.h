@@ -37,6 +37,13 @@ namespace eicrecon {
        */
       std::vector<int> pdgList;
 
+      /* fiducial cut: for each charged particle and radiator, only consider sensor hits within the
+       * expected ring footprint, i.e., seen within the radiator's maximum Cherenkov angle (for beta=1,
+       * computed from `referenceRIndex`) plus `fiducialMargin` around the particle direction
+       */
+      bool   fiducialCut    = false; // if true, apply the fiducial cut
+      double fiducialMargin = 0.1;   // angular margin added to the maximum Cherenkov angle [rad]
+
       /* cheat modes: useful for test purposes, or idealizing; the real PID should run with all
        * cheat modes off
        */
@@ -77,6 +84,8 @@ namespace eicrecon {
           m_log->log(lvl, "  {:>20} = {:<}", name, val);
         };
         print_param("numRIndexBins",numRIndexBins);
+        print_param("fiducialCut",fiducialCut);
+        print_param("fiducialMargin",fiducialMargin);
         PrintCheats(m_log, lvl, true);
         m_log->log(lvl, "pdgList:");
         for(const auto& pdg : pdgList) m_log->log(lvl, "  {}", pdg);
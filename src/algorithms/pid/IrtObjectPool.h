@@ -0,0 +1,71 @@
+// Copyright 2023, Christopher Dilks
+// Subject to the terms in the LICENSE file found in the top-level directory.
+
+// pool of IRT objects, recycled from event to event
+/* IRT objects own the objects added to them: a `ChargedParticle` deletes its
+ * `RadiatorHistory`s, which delete their `OpticalPhoton`s. Objects handed out
+ * by a pool remain owned by the pool instead; see `Detach()` for how they are
+ * reset without IRT deleting them.
+ *
+ * A pool is not thread safe; each algorithm instance has its own pools, and
+ * JANA runs each factory instance on one thread at a time.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace eicrecon {
+
+  template<class T>
+  class IrtObjectPool {
+    public:
+      IrtObjectPool() = default;
+      IrtObjectPool(const IrtObjectPool&) = delete;
+      IrtObjectPool& operator=(const IrtObjectPool&) = delete;
+
+      // detach all objects before deleting them, since they may point to objects of other pools
+      ~IrtObjectPool() {
+        for(auto& obj : m_objects) Detach(obj.get());
+      }
+
+      // get an object in its default state; it is valid until the next `Reset()`
+      T* Get() {
+        if(m_num_used == m_objects.size())
+          m_objects.push_back(std::make_unique<T>());
+        auto obj = m_objects[m_num_used++].get();
+        Detach(obj);
+        return obj;
+      }
+
+      // make all objects available again; call once per event
+      void Reset() { m_num_used = 0; }
+
+      std::size_t Size() const { return m_objects.size(); }
+
+    private:
+
+      // reset an object to its default state, dropping (without deleting) the pointers it holds
+      /* IRT has no reset or clear API for these classes, so this assigns a
+       * default-constructed object. That is only correct while the objects own
+       * no heap memory through raw pointers other than the pooled children,
+       * which holds for IRT 1.0 (the version EICrecon is built against):
+       * - `ChargedParticle`: owns its `RadiatorHistory`s (pooled); the radiator
+       *   keys point to the geometry, which IRT does not delete
+       * - `RadiatorHistory`: owns its `OpticalPhoton`s (pooled) and its
+       *   `ChargedParticleStep`s, which this algorithm never adds; the
+       *   charged particle track is stored in the radiator (`AddLocation`)
+       * - `OpticalPhoton`: its photon detector points to the geometry; the
+       *   selected hypotheses, PDFs and Cherenkov angles are held by value in
+       *   standard containers, which the assignment frees
+       * Check this again when updating IRT, or when using `AddStep`.
+       */
+      static void Detach(T* obj) { *obj = T(); }
+
+      std::vector<std::unique_ptr<T>> m_objects;
+      std::size_t m_num_used = 0;
+  };
+
+}
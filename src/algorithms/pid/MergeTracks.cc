@@ -25,6 +25,7 @@ std::unique_ptr<edm4eic::TrackSegmentCollection> eicrecon::MergeTracks::Algorith
 {
   // logging
   m_log->trace("{:=^70}"," call MergeTracks::AlgorithmProcess ");
+  EventArena::Scope arena_scope;
 
   // start output collection
   auto out_tracks = std::make_unique<edm4eic::TrackSegmentCollection>();
@@ -40,12 +41,15 @@ std::unique_ptr<edm4eic::TrackSegmentCollection> eicrecon::MergeTracks::Algorith
     }
   }
 
+  // local container to hold the track points of each track, reused for all tracks
+  EventArena::vector<edm4eic::TrackPoint> out_track_points(EventArena::resource());
+
   // loop over track collection elements
   for(std::size_t i_track=0; i_track<n_tracks; i_track++) {
 
-    // create a new output track, and a local container to hold its track points
+    // create a new output track
     auto out_track = out_tracks->create();
-    std::vector<edm4eic::TrackPoint> out_track_points;
+    out_track_points.clear();
 
     // loop over collections for this track, and add each track's points to `out_track_points`
     for(const auto& in_track_collection : in_track_collections) {
@@ -17,6 +17,7 @@
 
 // EICrecon
 #include <spdlog/spdlog.h>
+#include "algorithms/interfaces/EventArena.h"
 
 namespace eicrecon {
 
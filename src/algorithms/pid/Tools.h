@@ -8,8 +8,11 @@
 #pragma once
 
 // general
+#include <algorithm>
 #include <map>
 #include <math.h>
+#include <unordered_map>
+#include <vector>
 #include <spdlog/spdlog.h>
 
 // ROOT
@@ -25,6 +28,69 @@
 
 namespace eicrecon {
 
+  // Lookup table with equidistant abscissae, sampled from a piecewise-linear table `input` of
+  // (x,y) points (in any order); lookup is O(1), computing the bin index directly and
+  // interpolating linearly within the bin. The table is immutable once built.
+  class UniformGridTable {
+    public:
+      UniformGridTable() = default;
+      UniformGridTable(const std::vector<std::pair<double,double>> &input, unsigned nbins) {
+        auto points = SortedTable(input);
+        if(points.size() < 2 || nbins < 1) return;
+        m_min      = points.front().first;
+        m_max      = points.back().first;
+        m_inv_step = nbins / (m_max - m_min);
+        m_y.reserve(nbins+1);
+        std::size_t seg = 0;
+        for(unsigned i=0; i<=nbins; i++) {
+          double x = i==nbins ? m_max : m_min + i * (m_max - m_min) / nbins;
+          while(seg+2 < points.size() && points[seg+1].first < x) seg++;
+          const auto &p0 = points[seg];
+          const auto &p1 = points[seg+1];
+          m_y.push_back(p0.second + (x - p0.first) * (p1.second - p0.second) / (p1.first - p0.first));
+        }
+      }
+
+      bool   IsValid()        const { return m_y.size() >= 2; }
+      double GetMin()         const { return m_min; }
+      double GetMax()         const { return m_max; }
+      bool   InRange(double x) const { return IsValid() && x >= m_min && x <= m_max; }
+
+      // return the interpolated value at `x`, or `outside` if `x` is out of range
+      double Evaluate(double x, double outside=0.0) const {
+        double y;
+        return Interpolate(x, &y) ? y : outside;
+      }
+
+      // set `y` to the interpolated value at `x`; returns false if `x` is out of range
+      bool Interpolate(double x, double *y) const {
+        if(!InRange(x)) return false;
+        double      u = (x - m_min) * m_inv_step;
+        std::size_t i = std::min(static_cast<std::size_t>(u), m_y.size() - 2);
+        *y = m_y[i] + (u - i) * (m_y[i+1] - m_y[i]);
+        return true;
+      }
+
+      // sort `input` by x, keeping the last entry of duplicate x values
+      static std::vector<std::pair<double,double>> SortedTable(const std::vector<std::pair<double,double>> &input) {
+        auto points = input;
+        std::stable_sort(points.begin(), points.end(),
+            [] (const auto &a, const auto &b) { return a.first < b.first; });
+        std::vector<std::pair<double,double>> ret;
+        for(const auto &p : points) {
+          if(!ret.empty() && ret.back().first == p.first) ret.back() = p;
+          else ret.push_back(p);
+        }
+        return ret;
+      }
+
+    private:
+      double              m_min      = 0.0;
+      double              m_max      = 0.0;
+      double              m_inv_step = 0.0;
+      std::vector<double> m_y;
+  };
+
   // Tools class, filled with miscellaneous helper functions
   class Tools {
     public:
@@ -38,11 +104,12 @@ namespace eicrecon {
       // -------------------------------------------------------------------------------------
       // Radiator IDs
 
-      static std::unordered_map<int,std::string> GetRadiatorIDs() {
-        return std::unordered_map<int,std::string>{
+      static const std::unordered_map<int,std::string>& GetRadiatorIDs() {
+        static const std::unordered_map<int,std::string> radiator_ids{
           { 0, "Aerogel" },
           { 1, "Gas" }
         };
+        return radiator_ids;
       }
 
       static std::string GetRadiatorName(int id) {
@@ -68,14 +135,15 @@ namespace eicrecon {
       // local PDG mass database
       // FIXME: cannot use `TDatabasePDG` since it is not thread safe; until we
       // have a proper PDG database service, we hard-code the masses we need;
-      // use Tools::GetPDGMass for access
-      static std::unordered_map<int,double> GetPDGMasses() {
-        return std::unordered_map<int,double>{
+      // use Tools::GetPDGMass for access; the table is built once, and is immutable
+      static const std::unordered_map<int,double>& GetPDGMasses() {
+        static const std::unordered_map<int,double> pdg_masses{
           { 11,   0.000510999 },
           { 211,  0.13957     },
           { 321,  0.493677    },
           { 2212, 0.938272    }
         };
+        return pdg_masses;
       }
 
       static double GetPDGMass(int pdg) {
@@ -101,17 +169,14 @@ namespace eicrecon {
       {
         std::vector<std::pair<double, double>> ret;
 
-        // Well, could have probably just reordered the initial vector;
-        std::map<double, double> buffer;
-
-        for(auto entry: input)
-          buffer[entry.first] = entry.second;
+        // sorted copy of the input
+        auto buffer = UniformGridTable::SortedTable(input);
 
         // Sanity checks; return empty map in case do not pass them;
         if (buffer.size() < 2 || nbins < 2) return ret;
 
-        double from = (*buffer.begin()).first;
-        double to   = (*buffer.rbegin()).first;
+        double from = buffer.front().first;
+        double to   = buffer.back().first;
         // Will be "nbins+1" equidistant entries;
         double step = (to - from) / nbins;
 
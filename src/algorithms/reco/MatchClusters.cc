@@ -34,12 +34,13 @@ namespace eicrecon {
     }
 
     std::tuple<edm4eic::ReconstructedParticleCollection*, edm4eic::MCRecoParticleAssociationCollection*> MatchClusters::execute(
-            std::vector<const edm4hep::MCParticle *> mcparticles,
-            std::vector<const edm4eic::ReconstructedParticle *> inparts,
-            std::vector<const edm4eic::MCRecoParticleAssociation *> inpartsassoc,
+            const std::vector<const edm4hep::MCParticle *> &mcparticles,
+            const std::vector<const edm4eic::ReconstructedParticle *> &inparts,
+            const std::vector<const edm4eic::MCRecoParticleAssociation *> &inpartsassoc,
             const std::vector<std::vector<const edm4eic::Cluster*>> &cluster_collections,
             const std::vector<std::vector<const edm4eic::MCRecoClusterParticleAssociation*>> &cluster_assoc_collections) {
 
+        EventArena::Scope arena_scope;
         m_log->debug("Processing cluster info for new event");
 
         // Resulting reconstructed particles and associations
@@ -139,10 +140,10 @@ namespace eicrecon {
 
     // get a map of mcID --> cluster
     // input: cluster_collections --> list of handles to all cluster collections
-    std::map<int, const edm4eic::Cluster*> MatchClusters::indexedClusters(
+    EventArena::map<int, const edm4eic::Cluster*> MatchClusters::indexedClusters(
             const std::vector<std::vector<const edm4eic::Cluster*>> &cluster_collections,
             const std::vector<std::vector<const edm4eic::MCRecoClusterParticleAssociation*>> &associations_collections) {
-        std::map<int, const edm4eic::Cluster*> matched = {};
+        EventArena::map<int, const edm4eic::Cluster*> matched(EventArena::resource());
 
         // loop over cluster collections
         for (const auto &clusters: cluster_collections) {
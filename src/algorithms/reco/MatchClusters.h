@@ -24,6 +24,7 @@
 #include <edm4eic/TrackParametersCollection.h>
 #include <edm4eic/vector_utils.h>
 
+#include "algorithms/interfaces/EventArena.h"
 
 namespace eicrecon {
 
@@ -37,9 +38,9 @@ namespace eicrecon {
         void init(std::shared_ptr<spdlog::logger> logger);
 
         MatchingResults execute(
-            std::vector<const edm4hep::MCParticle *> mcparticles,
-            std::vector<const edm4eic::ReconstructedParticle *> inparts,
-            std::vector<const edm4eic::MCRecoParticleAssociation *> inpartsassoc,
+            const std::vector<const edm4hep::MCParticle *> &mcparticles,
+            const std::vector<const edm4eic::ReconstructedParticle *> &inparts,
+            const std::vector<const edm4eic::MCRecoParticleAssociation *> &inpartsassoc,
             const std::vector<std::vector<const edm4eic::Cluster*>> &cluster_collections,
             const std::vector<std::vector<const edm4eic::MCRecoClusterParticleAssociation*>> &cluster_assoc_collections);
 
@@ -49,7 +50,7 @@ namespace eicrecon {
 
         // get a map of mcID --> cluster
         // input: cluster_collections --> list of handles to all cluster collections
-        std::map<int, const edm4eic::Cluster*> indexedClusters(
+        EventArena::map<int, const edm4eic::Cluster*> indexedClusters(
                 const std::vector<std::vector<const edm4eic::Cluster*>> &cluster_collections,
                 const std::vector<std::vector<const edm4eic::MCRecoClusterParticleAssociation*>> &associations_collections);
 
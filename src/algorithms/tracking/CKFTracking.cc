@@ -23,6 +23,7 @@
 
 #include "extensions/spdlog/SpdlogToActs.h"
 #include "extensions/spdlog/SpdlogFormatters.h"
+#include "extensions/spdlog/SpdlogMacros.h"
 
 //#include "JugBase/DataHandle.h"
 #include "JugBase/BField/DD4hepBField.h"
@@ -72,6 +73,10 @@ namespace eicrecon {
                 },
         };
         m_trackFinderFunc = CKFTracking::makeCKFTrackingFunction(m_geoSvc->trackingGeometry(), m_BField);
+
+        // ACTS logger, made once rather than per event
+        auto logLevel = eicrecon::SpdlogToActsLevel(m_geoSvc->getActsRelatedLogger()->level());
+        m_acts_logger = Acts::getDefaultLogger("CKFTracking Logger", logLevel);
     }
 
     std::vector<eicrecon::TrackingResultTrajectory*> CKFTracking::process(const eicrecon::IndexSourceLinkContainer &src_links,
@@ -87,10 +92,6 @@ namespace eicrecon {
         //// Construct a perigee surface as the target surface
         auto pSurface = Acts::Surface::makeShared<Acts::PerigeeSurface>(Acts::Vector3{0., 0., 0.});
 
-        auto logLevel = eicrecon::SpdlogToActsLevel(m_geoSvc->getActsRelatedLogger()->level());
-
-        ACTS_LOCAL_LOGGER(Acts::getDefaultLogger("CKFTracking Logger", logLevel));
-
         Acts::PropagatorPlainOptions pOptions;
         pOptions.maxSteps = 10000;
 
@@ -122,7 +123,7 @@ namespace eicrecon {
         // Set the CombinatorialKalmanFilter options
         CKFTracking::TrackFinderOptions options(
                 m_geoctx, m_fieldctx, m_calibctx, slAccessorDelegate,
-                extensions, Acts::LoggerWrapper{logger()}, pOptions, &(*pSurface));
+                extensions, Acts::LoggerWrapper{*m_acts_logger}, pOptions, &(*pSurface));
 
         // TODO remove this hack...
 
@@ -147,7 +148,7 @@ namespace eicrecon {
                                                                               std::move(trackFindingOutput.lastMeasurementIndices),
                                                                               std::move(trackFindingOutput.fittedParameters)));
             } else {
-                m_log->debug("Track finding failed for truth seed {} with error: {}", iseed, result.error());
+                EICRECON_DEBUG(m_log, "Track finding failed for truth seed {} with error: {}", iseed, result.error());
             }
 
         }
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <random>
 #include <stdexcept>
 #include <vector>
@@ -28,6 +29,7 @@
 #include <Acts/Geometry/TrackingGeometry.hpp>
 #include <Acts/TrackFinding/CombinatorialKalmanFilter.hpp>
 #include <Acts/TrackFinding/MeasurementSelector.hpp>
+#include <Acts/Utilities/Logger.hpp>
 #include "CKFTrackingConfig.h"
 
 #include "algorithms/interfaces/WithPodConfig.h"
@@ -79,6 +81,7 @@ namespace eicrecon {
 
     private:
         std::shared_ptr<spdlog::logger> m_log;
+        std::unique_ptr<const Acts::Logger> m_acts_logger;
         std::shared_ptr<CKFTrackingFunction> m_trackFinderFunc;
         std::shared_ptr<const ActsGeometryProvider> m_geoSvc;
 
@@ -34,6 +34,7 @@
 #include "TrackProjectorConfig.h"
 #include "TrackProjector.h"
 #include "extensions/spdlog/SpdlogFormatters.h"
+#include "extensions/spdlog/SpdlogMacros.h"
 
 #include <cmath>
 
@@ -58,12 +59,12 @@ namespace eicrecon {
             // The trajectory entry indices and the multiTrajectory
             const auto &mj = traj->multiTrajectory();
             const auto &trackTips = traj->tips();
-            m_log->debug("------ Trajectory ------");
-            m_log->debug("  Num of elements in trackTips {}", trackTips.size());
+            EICRECON_DEBUG(m_log, "------ Trajectory ------");
+            EICRECON_DEBUG(m_log, "  Num of elements in trackTips {}", trackTips.size());
 
             // Skip empty
             if (trackTips.empty()) {
-                m_log->debug("  Empty multiTrajectory.");
+                EICRECON_DEBUG(m_log, "  Empty multiTrajectory.");
                 continue;
             }
             auto &trackTip = trackTips.front();
@@ -73,8 +74,8 @@ namespace eicrecon {
             int m_nMeasurements = trajState.nMeasurements;
             int m_nStates = trajState.nStates;
             int m_nCalibrated = 0;
-            m_log->debug("  Num measurement in trajectory {}", m_nMeasurements);
-            m_log->debug("  Num state in trajectory {}", m_nStates);
+            EICRECON_DEBUG(m_log, "  Num measurement in trajectory {}", m_nMeasurements);
+            EICRECON_DEBUG(m_log, "  Num state in trajectory {}", m_nStates);
 
             edm4eic::MutableTrackSegment track_segment;
 
@@ -159,23 +160,25 @@ namespace eicrecon {
                                           });
 
 
-                m_log->debug("  ******************************");
-                m_log->debug("    position: {}", position);
-                m_log->debug("    positionError: {}", positionError);
-                m_log->debug("    momentum: {}", momentum);
-                m_log->debug("    momentumError: {}", momentumError);
-                m_log->debug("    time: {}", time);
-                m_log->debug("    timeError: {}", timeError);
-                m_log->debug("    theta: {}", theta);
-                m_log->debug("    phi: {}", phi);
-                m_log->debug("    directionError: {}", directionError);
-                m_log->debug("    pathLength: {}", pathLength);
-                m_log->debug("    pathLengthError: {}", pathLengthError);
-                m_log->debug("    geoID = {}", geoID);
-                m_log->debug("    volume = {}, layer = {}", volume, layer);
-                m_log->debug("    pathlength = {}", pathLength);
-                m_log->debug("    hasCalibrated = {}", trackstate.hasCalibrated());
-                m_log->debug("  ******************************");
+                if (EICRECON_LOG_ENABLED(m_log, debug)) {
+                    m_log->debug("  ******************************");
+                    m_log->debug("    position: {}", position);
+                    m_log->debug("    positionError: {}", positionError);
+                    m_log->debug("    momentum: {}", momentum);
+                    m_log->debug("    momentumError: {}", momentumError);
+                    m_log->debug("    time: {}", time);
+                    m_log->debug("    timeError: {}", timeError);
+                    m_log->debug("    theta: {}", theta);
+                    m_log->debug("    phi: {}", phi);
+                    m_log->debug("    directionError: {}", directionError);
+                    m_log->debug("    pathLength: {}", pathLength);
+                    m_log->debug("    pathLengthError: {}", pathLengthError);
+                    m_log->debug("    geoID = {}", geoID);
+                    m_log->debug("    volume = {}, layer = {}", volume, layer);
+                    m_log->debug("    pathlength = {}", pathLength);
+                    m_log->debug("    hasCalibrated = {}", trackstate.hasCalibrated());
+                    m_log->debug("  ******************************");
+                }
 
                 // Local position on the reference surface.
                 //m_log->debug("parameter[eBoundLoc0] = {}", parameter[Acts::eBoundLoc0]);
@@ -187,8 +190,8 @@ namespace eicrecon {
                 //m_log->debug("predicted variables: {}", trackstate.predicted());
             });
 
-            m_log->debug("  Num calibrated state in trajectory {}", m_nCalibrated);
-            m_log->debug("------ end of trajectory process ------");
+            EICRECON_DEBUG(m_log, "  Num calibrated state in trajectory {}", m_nCalibrated);
+            EICRECON_DEBUG(m_log, "------ end of trajectory process ------");
 
             // Add to output collection
             track_segments.push_back(new edm4eic::TrackSegment(track_segment));
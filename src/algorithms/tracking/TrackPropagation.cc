@@ -79,7 +79,8 @@ namespace eicrecon {
         std::vector<const eicrecon::TrackingResultTrajectory*> trajectories,
         std::vector<std::shared_ptr<Acts::Surface>> targetSurfaces,
         std::function<bool(edm4eic::TrackPoint)> trackPointCut,
-        bool stopIfTrackPointCutFailed
+        bool stopIfTrackPointCutFailed,
+        std::function<bool(double,double)> acceptanceCut
         )
     {
       // logging
@@ -97,8 +98,18 @@ namespace eicrecon {
         decltype(edm4eic::TrackSegmentData::length)      length       = 0;
         decltype(edm4eic::TrackSegmentData::lengthError) length_error = 0;
 
+        // acceptance cut, on the direction at the first track state
+        bool accepted = true;
+        if(!traj->tips().empty()) {
+          auto momentum = traj->trackParameters(traj->tips().front()).momentum();
+          accepted = acceptanceCut(Acts::VectorHelpers::eta(momentum), Acts::VectorHelpers::phi(momentum));
+        }
+        if(!accepted)
+          m_log->trace("<> trajectory REJECTED by acceptanceCut");
+
         // loop over projection-target surfaces
         for(const auto& targetSurf : targetSurfaces) {
+          if(!accepted) break;
 
           // project the trajectory `traj` to this surface
           std::unique_ptr<edm4eic::TrackPoint> point;
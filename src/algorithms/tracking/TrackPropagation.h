@@ -49,12 +49,14 @@ namespace eicrecon {
 
         /** Propagates a collection of trajectories to a list of surfaces, and returns the full `TrackSegment`;
          *  optionally omit track points with `trackPointCut`.
+         *  Trajectories whose (eta,phi) fails `acceptanceCut` are not propagated, and get an empty `TrackSegment`.
          * @remark: being a simple wrapper of propagate(...) this method is more suitable for factories */
         std::unique_ptr<edm4eic::TrackSegmentCollection> propagateToSurfaceList(
             std::vector<const eicrecon::TrackingResultTrajectory*> trajectories,
             std::vector<std::shared_ptr<Acts::Surface>> targetSurfaces,
             std::function<bool(edm4eic::TrackPoint)> trackPointCut = [] (edm4eic::TrackPoint p) { return true; },
-            bool stopIfTrackPointCutFailed = false
+            bool stopIfTrackPointCutFailed = false,
+            std::function<bool(double,double)> acceptanceCut = [] (double eta, double phi) { return true; }
             );
 
     private:
@@ -6,6 +6,8 @@
 #include "BEMCcheckProcessor.h"
 #include "services/rootfile/RootFile_service.h"
 
+#include <JANA/JEvent.h>
+
 #include <Evaluator/DD4hepUnits.h>
 
 // The following just makes this a JANA plugin
@@ -17,82 +19,100 @@ extern "C" {
 }
 
 //-------------------------------------------
-// InitWithGlobalRootLock
+// Init
 //-------------------------------------------
-void BEMCcheckProcessor::InitWithGlobalRootLock(){
+void BEMCcheckProcessor::Init(){
+
+    auto app = GetApplication();
+    auto rootfile_svc = app->GetService<RootFile_service>();
+    auto hist_svc = app->GetService<ThreadHistogram_service>();
 
-    auto rootfile_svc = GetApplication()->GetService<RootFile_service>();
+    // Histograms are created in the output file with the global root lock held,
+    // then each thread fills its own copies (see ThreadHistogram_service)
+    auto globalRootLock = app->GetService<JGlobalRootLock>();
+    globalRootLock->acquire_write_lock();
     auto rootfile = rootfile_svc->GetHistFile();
     rootfile->mkdir("BEMC")->cd();
 
-    hist1D["EcalBarrelhits_hits_per_event"]  =  new TH1I("EcalBarrelhits_hits_per_event",  "BEMC Simulated hit Nhits/event;Nhits",  300, 0.0, 3000);
+    hist1D["EcalBarrelhits_hits_per_event"]  =  hist_svc->Register<TH1>(new TH1I("EcalBarrelhits_hits_per_event",  "BEMC Simulated hit Nhits/event;Nhits",  300, 0.0, 3000));
 //    hist2D["EcalBarrelhits_occupancy"]  =  new TH2I("EcalBarrelhits_occupancy",  "BEMC Simulated hit occupancy;column;row",  64, -32.0, 32.0,  64, -32.0, 32.0);
-    hist1D["EcalBarrelhits_hit_energy"] =  new TH1D("EcalBarrelhits_hit_energy",  "BEMC Simulated hit energy;GeV",  1000, 0.0, 2.0);
+    hist1D["EcalBarrelhits_hit_energy"] =  hist_svc->Register<TH1>(new TH1D("EcalBarrelhits_hit_energy",  "BEMC Simulated hit energy;GeV",  1000, 0.0, 2.0));
 
-    hist1D["EcalBarrelRawhits_hits_per_event"]  =  new TH1I("EcalBarrelRawhits_hits_per_event",  "BEMC Simulated digitized hit Nhits/event;Nhits",  300, 0.0, 3000);
-    hist1D["EcalBarrelRawhits_amplitude"] =  new TH1D("EcalBarrelRawhits_amplitude",  "BEMC Simulated digitized hit amplitude;amplitude",  1000, 0.0, 8200.0);
-    hist1D["EcalBarrelRawhits_timestamp"] =  new TH1I("EcalBarrelRawhits_timestamp",  "BEMC Simulated digitized hit timestamp;timestamp",  1024, 0.0, 8191.0);
+    hist1D["EcalBarrelRawhits_hits_per_event"]  =  hist_svc->Register<TH1>(new TH1I("EcalBarrelRawhits_hits_per_event",  "BEMC Simulated digitized hit Nhits/event;Nhits",  300, 0.0, 3000));
+    hist1D["EcalBarrelRawhits_amplitude"] =  hist_svc->Register<TH1>(new TH1D("EcalBarrelRawhits_amplitude",  "BEMC Simulated digitized hit amplitude;amplitude",  1000, 0.0, 8200.0));
+    hist1D["EcalBarrelRawhits_timestamp"] =  hist_svc->Register<TH1>(new TH1I("EcalBarrelRawhits_timestamp",  "BEMC Simulated digitized hit timestamp;timestamp",  1024, 0.0, 8191.0));
 
-    hist1D["EcalBarrelRechits_hits_per_event"]  =  new TH1I("EcalBarrelRechits_hits_per_event",  "BEMC Reconstructed hit Nhits/event;Nhits",  300, 0.0, 3000);
-    hist1D["EcalBarrelRecHits_hit_energy"] =  new TH1D("EcalBarrelRecHits_hit_energy",  "BEMC Reconstructed hit energy;MeV",  1000, 0.0, 100.0);
-    hist2D["EcalBarrelRecHits_xy"]  =  new TH2D("EcalBarrelRecHits_xy",  "BEMC Reconstructed hit Y vs. X (energy weighted);x;y",  128, -1100.0, 1100.0,  128, -1100.0, 1100.0);
-    hist1D["EcalBarrelRecHits_z"]  =  new TH1D("EcalBarrelRecHits_z",  "BEMC Reconstructed hit Z;z",  400, -3000.0, 1600.0);
-    hist1D["EcalBarrelRecHits_time"]  =  new TH1D("EcalBarrelRecHits_time",  "BEMC Reconstructed hit time;time",  1000, -10.0, 2000.0);
+    hist1D["EcalBarrelRechits_hits_per_event"]  =  hist_svc->Register<TH1>(new TH1I("EcalBarrelRechits_hits_per_event",  "BEMC Reconstructed hit Nhits/event;Nhits",  300, 0.0, 3000));
+    hist1D["EcalBarrelRecHits_hit_energy"] =  hist_svc->Register<TH1>(new TH1D("EcalBarrelRecHits_hit_energy",  "BEMC Reconstructed hit energy;MeV",  1000, 0.0, 100.0));
+    hist2D["EcalBarrelRecHits_xy"]  =  hist_svc->Register<TH2>(new TH2D("EcalBarrelRecHits_xy",  "BEMC Reconstructed hit Y vs. X (energy weighted);x;y",  128, -1100.0, 1100.0,  128, -1100.0, 1100.0));
+    hist1D["EcalBarrelRecHits_z"]  =  hist_svc->Register<TH1>(new TH1D("EcalBarrelRecHits_z",  "BEMC Reconstructed hit Z;z",  400, -3000.0, 1600.0));
+    hist1D["EcalBarrelRecHits_time"]  =  hist_svc->Register<TH1>(new TH1D("EcalBarrelRecHits_time",  "BEMC Reconstructed hit time;time",  1000, -10.0, 2000.0));
 
-    hist1D["EcalBarrelIslandProtoClusters_clusters_per_event"]  =  new TH1I("EcalBarrelIslandProtoClusters_clusters_per_event",  "BEMC Protoclusters Nclusters/event;Nclusters",  61, -0.5, 60.5);
-    hist1D["EcalBarrelIslandProtoClusters_hits_per_cluster"] = new TH1I("EcalBarrelIslandProtoClusters_hits_per_cluster",  "BEMC Protoclusters Nhits/cluster;Nhits",  101, -0.5, 100.5);
+    hist1D["EcalBarrelIslandProtoClusters_clusters_per_event"]  =  hist_svc->Register<TH1>(new TH1I("EcalBarrelIslandProtoClusters_clusters_per_event",  "BEMC Protoclusters Nclusters/event;Nclusters",  61, -0.5, 60.5));
+    hist1D["EcalBarrelIslandProtoClusters_hits_per_cluster"] = hist_svc->Register<TH1>(new TH1I("EcalBarrelIslandProtoClusters_hits_per_cluster",  "BEMC Protoclusters Nhits/cluster;Nhits",  101, -0.5, 100.5));
 
     // Set some draw options
 //    hist2D["EcalBarrelhits_occupancy"]->SetOption("colz");
-    hist2D["EcalBarrelRecHits_xy"]->SetOption("colz");
+    hist2D.at("EcalBarrelRecHits_xy").Merged()->SetOption("colz");
+
+    globalRootLock->release_lock();
 }
 
 //-------------------------------------------
-// ProcessSequential
+// Process
 //-------------------------------------------
-void BEMCcheckProcessor::ProcessSequential(const std::shared_ptr<const JEvent>& event) {
+void BEMCcheckProcessor::Process(const std::shared_ptr<const JEvent>& event) {
+
+    // Data objects we will need from JANA
+    auto EcalBarrelhits = event->Get<edm4hep::SimCalorimeterHit>("EcalBarrelHits");
+    auto EcalBarrelRawhits = event->Get<edm4hep::RawCalorimeterHit>("EcalBarrelRawHits");
+    auto EcalBarrelRecHits = event->Get<edm4eic::CalorimeterHit>("EcalBarrelRecHits");
+    auto EcalBarrelIslandProtoClusters = event->Get<edm4eic::ProtoCluster>("EcalBarrelIslandProtoClusters");
 
     // Fill histograms here
 
     // EcalBarrelhits
-    hist1D["EcalBarrelhits_hits_per_event"]->Fill(EcalBarrelhits().size());
-    for( auto hit : EcalBarrelhits()  ){
+    hist1D.at("EcalBarrelhits_hits_per_event")->Fill(EcalBarrelhits.size());
+    for( auto hit : EcalBarrelhits  ){
 //        auto row = floor(hit->getPosition().y/20.5); // 20.5 is empirical
 //        auto col = floor(hit->getPosition().x/20.5); // 20.5 is empirical
 //        hist2D["EcalBarrelhits_occupancy"]->Fill(row, col);
 
-        hist1D["EcalBarrelhits_hit_energy"]->Fill(hit->getEnergy());
+        hist1D.at("EcalBarrelhits_hit_energy")->Fill(hit->getEnergy());
     }
 
     // EcalBarrelRawhits
-    hist1D["EcalBarrelRawhits_hits_per_event"]->Fill(EcalBarrelRawhits().size());
-    for( auto hit : EcalBarrelRawhits()  ){
-        hist1D["EcalBarrelRawhits_amplitude"]->Fill( hit->getAmplitude() );
-        hist1D["EcalBarrelRawhits_timestamp"]->Fill( hit->getTimeStamp() );
+    hist1D.at("EcalBarrelRawhits_hits_per_event")->Fill(EcalBarrelRawhits.size());
+    for( auto hit : EcalBarrelRawhits  ){
+        hist1D.at("EcalBarrelRawhits_amplitude")->Fill( hit->getAmplitude() );
+        hist1D.at("EcalBarrelRawhits_timestamp")->Fill( hit->getTimeStamp() );
     }
 
     // EcalBarrelRechits
-    hist1D["EcalBarrelRechits_hits_per_event"]->Fill(EcalBarrelRecHits().size());
-    for( auto hit : EcalBarrelRecHits()  ){
+    hist1D.at("EcalBarrelRechits_hits_per_event")->Fill(EcalBarrelRecHits.size());
+    for( auto hit : EcalBarrelRecHits  ){
         auto &pos = hit->getPosition();
-        hist1D["EcalBarrelRecHits_hit_energy"]->Fill(hit->getEnergy() / dd4hep::MeV);
-        hist2D["EcalBarrelRecHits_xy"]->Fill( pos.x, pos.y, hit->getEnergy() );
-        hist1D["EcalBarrelRecHits_z"]->Fill(pos.z);
-        hist1D["EcalBarrelRecHits_time"]->Fill( hit->getTime() );
+        hist1D.at("EcalBarrelRecHits_hit_energy")->Fill(hit->getEnergy() / dd4hep::MeV);
+        hist2D.at("EcalBarrelRecHits_xy")->Fill( pos.x, pos.y, hit->getEnergy() );
+        hist1D.at("EcalBarrelRecHits_z")->Fill(pos.z);
+        hist1D.at("EcalBarrelRecHits_time")->Fill( hit->getTime() );
     }
 
 
     // EcalBarrelIslandProtoClusters
-    hist1D["EcalBarrelIslandProtoClusters_clusters_per_event"]->Fill(EcalBarrelIslandProtoClusters().size());
-    for (auto proto : EcalBarrelIslandProtoClusters() ){
-        hist1D["EcalBarrelIslandProtoClusters_hits_per_cluster"]->Fill( proto->getHits().size() );
+    hist1D.at("EcalBarrelIslandProtoClusters_clusters_per_event")->Fill(EcalBarrelIslandProtoClusters.size());
+    for (auto proto : EcalBarrelIslandProtoClusters ){
+        hist1D.at("EcalBarrelIslandProtoClusters_hits_per_cluster")->Fill( proto->getHits().size() );
     }
 }
 
 //-------------------------------------------
-// FinishWithGlobalRootLock
+// Finish
 //-------------------------------------------
-void BEMCcheckProcessor::FinishWithGlobalRootLock() {
+void BEMCcheckProcessor::Finish() {
+
+    // Add up the histograms of all threads
+    GetApplication()->GetService<ThreadHistogram_service>()->Merge();
 
     // Do any final calculations here.
 
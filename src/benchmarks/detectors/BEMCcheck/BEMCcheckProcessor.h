@@ -3,10 +3,12 @@
 // Template for this file generated with eicmkplugin.py
 //
 
-#include <JANA/JEventProcessorSequentialRoot.h>
+#include <JANA/JEventProcessor.h>
 #include <TH2.h>
 #include <TFile.h>
 
+#include "services/rootfile/ThreadHistogram_service.h"
+
 #include <edm4hep/SimCalorimeterHit.h>
 #include <edm4hep/RawCalorimeterHit.h>
 #include <edm4eic/ProtoCluster.h>
@@ -17,23 +19,17 @@
 // #include "detectors/BEMC/BEMCRawCalorimeterHit.h"
 
 
-class BEMCcheckProcessor: public JEventProcessorSequentialRoot {
+class BEMCcheckProcessor: public JEventProcessor {
 private:
 
-    // Data objects we will need from JANA e.g.
-    PrefetchT<edm4hep::SimCalorimeterHit> EcalBarrelhits                 = {this, "EcalBarrelHits"};
-    PrefetchT<edm4hep::RawCalorimeterHit> EcalBarrelRawhits              = {this, "EcalBarrelRawHits"};
-    PrefetchT<edm4eic::CalorimeterHit>    EcalBarrelRecHits              = {this, "EcalBarrelRecHits"};
-    PrefetchT<edm4eic::ProtoCluster>      EcalBarrelIslandProtoClusters  = {this, "EcalBarrelIslandProtoClusters"};
-
-    // Declare histogram and tree pointers
-    std::map<std::string, TH1*> hist1D;
-    std::map<std::string, TH2*> hist2D;
+    // Declare histograms, filled by each thread (see ThreadHistogram_service)
+    std::map<std::string, ThreadHistogram<TH1>> hist1D;
+    std::map<std::string, ThreadHistogram<TH2>> hist2D;
 
 public:
     BEMCcheckProcessor() { SetTypeName(NAME_OF_THIS); }
 
-    void InitWithGlobalRootLock() override;
-    void ProcessSequential(const std::shared_ptr<const JEvent>& event) override;
-    void FinishWithGlobalRootLock() override;
+    void Init() override;
+    void Process(const std::shared_ptr<const JEvent>& event) override;
+    void Finish() override;
 };
@@ -6,6 +6,8 @@
 #include "RPOTScheckProcessor.h"
 #include "services/rootfile/RootFile_service.h"
 
+#include <JANA/JEvent.h>
+
 #include <Evaluator/DD4hepUnits.h>
 #include <TVector3.h>
 
@@ -18,89 +20,107 @@ extern "C" {
 }
 
 //-------------------------------------------
-// InitWithGlobalRootLock
+// Init
 //-------------------------------------------
-void RPOTScheckProcessor::InitWithGlobalRootLock(){
+void RPOTScheckProcessor::Init(){
+
+    auto app = GetApplication();
+    auto rootfile_svc = app->GetService<RootFile_service>();
+    auto hist_svc = app->GetService<ThreadHistogram_service>();
 
-    auto rootfile_svc = GetApplication()->GetService<RootFile_service>();
+    // Histograms are created in the output file with the global root lock held,
+    // then each thread fills its own copies (see ThreadHistogram_service)
+    auto globalRootLock = app->GetService<JGlobalRootLock>();
+    globalRootLock->acquire_write_lock();
     auto rootfile = rootfile_svc->GetHistFile();
     rootfile->mkdir("RPOTS")->cd();
 
-    hist1D["ForwardRomanPotHits_hits_per_event"]  =  new TH1I("ForwardRomanPotHits_hits_per_event",  "RPOTS Simulated hit Nhits/event;Nhits",  201, -0.5, 200.5);
-    hist1D["ForwardRomanPotHits_EDep"] =  new TH1D("ForwardRomanPotHits_EDep",  "RPOTS Simulated hit energy;MeV",  1000, 0.0, 5.0);
-    hist1D["ForwardRomanPotHits_time"] =  new TH1D("ForwardRomanPotHits_time",  "RPOTS Simulated hit time;time (ns)",  150, 85.0, 100.0);
-    hist1D["ForwardRomanPotHits_pathlength"] =  new TH1D("ForwardRomanPotHits_pathlength",  "RPOTS Simulated hit path length;path length",  200, 0.0, 5.0);
-    hist2D["ForwardRomanPotHits_xy"]  =  new TH2D("ForwardRomanPotHits_xy",  "RPOTS Simulated hit hit Y vs. X;x;y",  100, -1070.0, -680.0,  100, -80., 80.0);
-    hist1D["ForwardRomanPotHits_z"] =  new TH1D("ForwardRomanPotHits_z",  "RPOTS Simulated hit Z;z",  200, 25000.0, 29000.0);
-    hist1D["ForwardRomanPotHits_p"] =  new TH1D("ForwardRomanPotHits_p",  "RPOTS Simulated hit momentum;p",  1000, 0.0, 10.0);
-    hist1D["ForwardRomanPotHits_theta"] =  new TH1D("ForwardRomanPotHits_theta",  "RPOTS Simulated hit #theta;#theta (mrad)",  400, 0.0, 2000.0);
-    hist1D["ForwardRomanPotHits_phi"] =  new TH1D("ForwardRomanPotHits_phi",  "RPOTS Simulated hit #phi;#phi (rad)",  200, -3.1416, 3.1416);
+    hist1D["ForwardRomanPotHits_hits_per_event"]  =  hist_svc->Register<TH1>(new TH1I("ForwardRomanPotHits_hits_per_event",  "RPOTS Simulated hit Nhits/event;Nhits",  201, -0.5, 200.5));
+    hist1D["ForwardRomanPotHits_EDep"] =  hist_svc->Register<TH1>(new TH1D("ForwardRomanPotHits_EDep",  "RPOTS Simulated hit energy;MeV",  1000, 0.0, 5.0));
+    hist1D["ForwardRomanPotHits_time"] =  hist_svc->Register<TH1>(new TH1D("ForwardRomanPotHits_time",  "RPOTS Simulated hit time;time (ns)",  150, 85.0, 100.0));
+    hist1D["ForwardRomanPotHits_pathlength"] =  hist_svc->Register<TH1>(new TH1D("ForwardRomanPotHits_pathlength",  "RPOTS Simulated hit path length;path length",  200, 0.0, 5.0));
+    hist2D["ForwardRomanPotHits_xy"]  =  hist_svc->Register<TH2>(new TH2D("ForwardRomanPotHits_xy",  "RPOTS Simulated hit hit Y vs. X;x;y",  100, -1070.0, -680.0,  100, -80., 80.0));
+    hist1D["ForwardRomanPotHits_z"] =  hist_svc->Register<TH1>(new TH1D("ForwardRomanPotHits_z",  "RPOTS Simulated hit Z;z",  200, 25000.0, 29000.0));
+    hist1D["ForwardRomanPotHits_p"] =  hist_svc->Register<TH1>(new TH1D("ForwardRomanPotHits_p",  "RPOTS Simulated hit momentum;p",  1000, 0.0, 10.0));
+    hist1D["ForwardRomanPotHits_theta"] =  hist_svc->Register<TH1>(new TH1D("ForwardRomanPotHits_theta",  "RPOTS Simulated hit #theta;#theta (mrad)",  400, 0.0, 2000.0));
+    hist1D["ForwardRomanPotHits_phi"] =  hist_svc->Register<TH1>(new TH1D("ForwardRomanPotHits_phi",  "RPOTS Simulated hit #phi;#phi (rad)",  200, -3.1416, 3.1416));
 
-    hist1D["ForwardRomanPotRawHits_hits_per_event"]  =  new TH1I("ForwardRomanPotRawHits_hits_per_event",  "RPOTS Simulated digitized hit Nhits/event;Nhits",  201, -0.5, 200.5);
-    hist1D["ForwardRomanPotRawHits_charge"] =  new TH1D("ForwardRomanPotRawHits_charge",  "RPOTS Simulated digitized hit charge;charge",  400, 0.0, 3.5E5);
-    hist1D["ForwardRomanPotRawHits_timestamp"] =  new TH1I("ForwardRomanPotRawHits_timestamp",  "RPOTS Simulated digitized hit timestamp;timestamp",  1024, 0.0, 8191.0);
+    hist1D["ForwardRomanPotRawHits_hits_per_event"]  =  hist_svc->Register<TH1>(new TH1I("ForwardRomanPotRawHits_hits_per_event",  "RPOTS Simulated digitized hit Nhits/event;Nhits",  201, -0.5, 200.5));
+    hist1D["ForwardRomanPotRawHits_charge"] =  hist_svc->Register<TH1>(new TH1D("ForwardRomanPotRawHits_charge",  "RPOTS Simulated digitized hit charge;charge",  400, 0.0, 3.5E5));
+    hist1D["ForwardRomanPotRawHits_timestamp"] =  hist_svc->Register<TH1>(new TH1I("ForwardRomanPotRawHits_timestamp",  "RPOTS Simulated digitized hit timestamp;timestamp",  1024, 0.0, 8191.0));
 
-    hist1D["ForwardRomanPotRecHits_hits_per_event"]  =  new TH1I("ForwardRomanPotRecHits_hits_per_event",  "RPOTS Reconstructed hit Nhits/event;Nhits",  201, -0.5, 200.5);
-    hist1D["ForwardRomanPotRecHits_time"]  =  new TH1D("ForwardRomanPotRecHits_time",  "RPOTS Reconstructed hit time;time",  200, -300.0, 300.0);
-    hist1D["ForwardRomanPotRecHits_Edep"] =  new TH1D("ForwardRomanPotRecHits_EDep",  "RPOTS Reconstructed hit energy;MeV",  200, 0.0, 8.0E4);
-    hist2D["ForwardRomanPotRecHits_xy"]  =  new TH2D("ForwardRomanPotRecHits_xy",  "RPOTS Reconstructed hit hit Y vs. X;x;y",  100, -1070.0, -680.0,  100, -80., 80.0);
-    hist1D["ForwardRomanPotRecHits_z"] =  new TH1D("ForwardRomanPotRecHits_z",  "RPOTS Reconstructed hit Z;z",  200, 25000.0, 29000.0);
+    hist1D["ForwardRomanPotRecHits_hits_per_event"]  =  hist_svc->Register<TH1>(new TH1I("ForwardRomanPotRecHits_hits_per_event",  "RPOTS Reconstructed hit Nhits/event;Nhits",  201, -0.5, 200.5));
+    hist1D["ForwardRomanPotRecHits_time"]  =  hist_svc->Register<TH1>(new TH1D("ForwardRomanPotRecHits_time",  "RPOTS Reconstructed hit time;time",  200, -300.0, 300.0));
+    hist1D["ForwardRomanPotRecHits_Edep"] =  hist_svc->Register<TH1>(new TH1D("ForwardRomanPotRecHits_EDep",  "RPOTS Reconstructed hit energy;MeV",  200, 0.0, 8.0E4));
+    hist2D["ForwardRomanPotRecHits_xy"]  =  hist_svc->Register<TH2>(new TH2D("ForwardRomanPotRecHits_xy",  "RPOTS Reconstructed hit hit Y vs. X;x;y",  100, -1070.0, -680.0,  100, -80., 80.0));
+    hist1D["ForwardRomanPotRecHits_z"] =  hist_svc->Register<TH1>(new TH1D("ForwardRomanPotRecHits_z",  "RPOTS Reconstructed hit Z;z",  200, 25000.0, 29000.0));
 
-    hist1D["FarForwardParticles_particles_per_event"]  =  new TH1I("FarForwardParticles_particles_per_event",  "RPOTS Reconstructed particles/event;Nparticles",  201, -0.5, 200.5);
+    hist1D["FarForwardParticles_particles_per_event"]  =  hist_svc->Register<TH1>(new TH1I("FarForwardParticles_particles_per_event",  "RPOTS Reconstructed particles/event;Nparticles",  201, -0.5, 200.5));
 
     // Set some draw options
-    hist2D["ForwardRomanPotHits_xy"]->SetOption("colz");
-    hist2D["ForwardRomanPotRecHits_xy"]->SetOption("colz");
+    hist2D.at("ForwardRomanPotHits_xy").Merged()->SetOption("colz");
+    hist2D.at("ForwardRomanPotRecHits_xy").Merged()->SetOption("colz");
+
+    globalRootLock->release_lock();
 }
 
 //-------------------------------------------
-// ProcessSequential
+// Process
 //-------------------------------------------
-void RPOTScheckProcessor::ProcessSequential(const std::shared_ptr<const JEvent>& event) {
+void RPOTScheckProcessor::Process(const std::shared_ptr<const JEvent>& event) {
+
+    // Data objects we will need from JANA
+    auto ForwardRomanPotHits = event->Get<edm4hep::SimTrackerHit>("ForwardRomanPotHits");
+    auto ForwardRomanPotRawHits = event->Get<edm4eic::RawTrackerHit>("ForwardRomanPotRawHits");
+    auto ForwardRomanPotRecHits = event->Get<edm4eic::TrackerHit>("ForwardRomanPotRecHits");
+    auto ForwardRomanPotParticles = event->Get<edm4eic::ReconstructedParticle>("ForwardRomanPotParticles");
 
     // Fill histograms here
 
     // ForwardRomanPotHits
-    hist1D["ForwardRomanPotHits_hits_per_event"]->Fill(ForwardRomanPotHits().size());
+    hist1D.at("ForwardRomanPotHits_hits_per_event")->Fill(ForwardRomanPotHits.size());
 
-    for( auto hit : ForwardRomanPotHits() ){
-        hist1D["ForwardRomanPotHits_EDep"]->Fill( hit->getEDep() / dd4hep::MeV);
-        hist1D["ForwardRomanPotHits_time"]->Fill( hit->getTime());
-        hist1D["ForwardRomanPotHits_pathlength"]->Fill( hit->getPathLength());
+    for( auto hit : ForwardRomanPotHits ){
+        hist1D.at("ForwardRomanPotHits_EDep")->Fill( hit->getEDep() / dd4hep::MeV);
+        hist1D.at("ForwardRomanPotHits_time")->Fill( hit->getTime());
+        hist1D.at("ForwardRomanPotHits_pathlength")->Fill( hit->getPathLength());
 
-        hist2D["ForwardRomanPotHits_xy"]->Fill( hit->getPosition().x, hit->getPosition().y);
-        hist1D["ForwardRomanPotHits_z"]->Fill( hit->getPosition().z);
+        hist2D.at("ForwardRomanPotHits_xy")->Fill( hit->getPosition().x, hit->getPosition().y);
+        hist1D.at("ForwardRomanPotHits_z")->Fill( hit->getPosition().z);
 
         TVector3 mom( hit->getMomentum().x, hit->getMomentum().y, hit->getMomentum().z );
-        hist1D["ForwardRomanPotHits_p"]->Fill( mom.Mag() );
-        hist1D["ForwardRomanPotHits_theta"]->Fill( mom.Theta()*1000.0 );
-        hist1D["ForwardRomanPotHits_phi"]->Fill( mom.Phi() );
+        hist1D.at("ForwardRomanPotHits_p")->Fill( mom.Mag() );
+        hist1D.at("ForwardRomanPotHits_theta")->Fill( mom.Theta()*1000.0 );
+        hist1D.at("ForwardRomanPotHits_phi")->Fill( mom.Phi() );
     }
 
     // ForwardRomanPotRawHits
-    hist1D["ForwardRomanPotRawHits_hits_per_event"]->Fill(ForwardRomanPotRawHits().size());
-    for( auto hit : ForwardRomanPotRawHits()  ){
-        hist1D["ForwardRomanPotRawHits_charge"]->Fill( hit->getCharge() );
-        hist1D["ForwardRomanPotRawHits_timestamp"]->Fill( hit->getTimeStamp() );
+    hist1D.at("ForwardRomanPotRawHits_hits_per_event")->Fill(ForwardRomanPotRawHits.size());
+    for( auto hit : ForwardRomanPotRawHits  ){
+        hist1D.at("ForwardRomanPotRawHits_charge")->Fill( hit->getCharge() );
+        hist1D.at("ForwardRomanPotRawHits_timestamp")->Fill( hit->getTimeStamp() );
     }
 
     // ForwardRomanPotRecHits
-    hist1D["ForwardRomanPotRecHits_hits_per_event"]->Fill(ForwardRomanPotRecHits().size());
-    for( auto hit : ForwardRomanPotRecHits() ){
-        hist1D["ForwardRomanPotRecHits_Edep"]->Fill( hit->getEdep() / dd4hep::MeV);
-        hist1D["ForwardRomanPotRecHits_time"]->Fill( hit->getTime());
+    hist1D.at("ForwardRomanPotRecHits_hits_per_event")->Fill(ForwardRomanPotRecHits.size());
+    for( auto hit : ForwardRomanPotRecHits ){
+        hist1D.at("ForwardRomanPotRecHits_Edep")->Fill( hit->getEdep() / dd4hep::MeV);
+        hist1D.at("ForwardRomanPotRecHits_time")->Fill( hit->getTime());
 
-        hist2D["ForwardRomanPotRecHits_xy"]->Fill( hit->getPosition().x, hit->getPosition().y);
-        hist1D["ForwardRomanPotRecHits_z"]->Fill( hit->getPosition().z);
+        hist2D.at("ForwardRomanPotRecHits_xy")->Fill( hit->getPosition().x, hit->getPosition().y);
+        hist1D.at("ForwardRomanPotRecHits_z")->Fill( hit->getPosition().z);
     }
 
-    hist1D["FarForwardParticles_particles_per_event"]->Fill(ForwardRomanPotParticles().size());
+    hist1D.at("FarForwardParticles_particles_per_event")->Fill(ForwardRomanPotParticles.size());
 }
 
 //-------------------------------------------
-// FinishWithGlobalRootLock
+// Finish
 //-------------------------------------------
-void RPOTScheckProcessor::FinishWithGlobalRootLock() {
+void RPOTScheckProcessor::Finish() {
+
+    // Add up the histograms of all threads
+    GetApplication()->GetService<ThreadHistogram_service>()->Merge();
 
     // Do any final calculations here.
 
@@ -3,33 +3,29 @@
 // Template for this file generated with eicmkplugin.py
 //
 
-#include <JANA/JEventProcessorSequentialRoot.h>
+#include <JANA/JEventProcessor.h>
 #include <TH2.h>
 #include <TFile.h>
 
+#include "services/rootfile/ThreadHistogram_service.h"
+
 #include <edm4hep/SimTrackerHit.h>
 #include <edm4eic/RawTrackerHit.h>
 #include <edm4eic/TrackerHit.h>
 #include <edm4eic/ReconstructedParticle.h>
 
 
-class RPOTScheckProcessor: public JEventProcessorSequentialRoot {
+class RPOTScheckProcessor: public JEventProcessor {
 private:
 
-    // Data objects we will need from JANA
-    PrefetchT<edm4hep::SimTrackerHit>         ForwardRomanPotHits     = {this, "ForwardRomanPotHits"};
-    PrefetchT<edm4eic::RawTrackerHit>         ForwardRomanPotRawHits    = {this, "ForwardRomanPotRawHits"};
-    PrefetchT<edm4eic::TrackerHit>            ForwardRomanPotRecHits    = {this, "ForwardRomanPotRecHits"};
-    PrefetchT<edm4eic::ReconstructedParticle> ForwardRomanPotParticles  = {this, "ForwardRomanPotParticles"};
-
-    // Containers for histograms
-    std::map<std::string, TH1*> hist1D;
-    std::map<std::string, TH2*> hist2D;
+    // Containers for histograms, filled by each thread (see ThreadHistogram_service)
+    std::map<std::string, ThreadHistogram<TH1>> hist1D;
+    std::map<std::string, ThreadHistogram<TH2>> hist2D;
 
 public:
     RPOTScheckProcessor() { SetTypeName(NAME_OF_THIS); }
 
-    void InitWithGlobalRootLock() override;
-    void ProcessSequential(const std::shared_ptr<const JEvent>& event) override;
-    void FinishWithGlobalRootLock() override;
+    void Init() override;
+    void Process(const std::shared_ptr<const JEvent>& event) override;
+    void Finish() override;
 };
@@ -23,17 +23,21 @@ void HitReconstructionAnalysis::init(JApplication *app, TDirectory *plugin_tdir)
     auto r_limit_min = 0;
     auto r_limit_max = 1200;
 
-    m_total_occup_th2 = new TH2F("total_occup", "Occupancy plot for all readouts", 200, z_limit_min, +z_limit_max, 100, r_limit_min, r_limit_max);
-    m_total_occup_th2->SetDirectory(dir);
+    // Histograms are filled by each thread and merged at the end
+    auto hist_service = app->GetService<ThreadHistogram_service>();
+
+    auto total_occup_th2 = new TH2F("total_occup", "Occupancy plot for all readouts", 200, z_limit_min, +z_limit_max, 100, r_limit_min, r_limit_max);
+    total_occup_th2->SetDirectory(dir);
+    m_total_occup_th2 = hist_service->Register(total_occup_th2);
 
     for(auto &name: m_data_names) {
-        auto count_hist = std::make_shared<TH1F>(("count_" + name).c_str(), ("Count hits for " + name).c_str(), 100, 0, 30);
+        auto count_hist = new TH1F(("count_" + name).c_str(), ("Count hits for " + name).c_str(), 100, 0, 30);
         count_hist->SetDirectory(dir);
-        m_hits_count_hists.push_back(count_hist);
+        m_hits_count_hists.push_back(hist_service->Register(count_hist));
 
-        auto occup_hist = std::make_shared<TH2F>(("occup_" + name).c_str(), ("Occupancy plot for" + name).c_str(), 100, z_limit_min, z_limit_max, 200, r_limit_min, r_limit_max);
+        auto occup_hist = new TH2F(("occup_" + name).c_str(), ("Occupancy plot for" + name).c_str(), 100, z_limit_min, z_limit_max, 200, r_limit_min, r_limit_max);
         occup_hist->SetDirectory(dir);
-        m_hits_occup_hists.push_back(occup_hist);
+        m_hits_occup_hists.push_back(hist_service->Register(occup_hist));
     }
 }
 
@@ -9,6 +9,8 @@
 #include <TH2F.h>
 #include <JANA/JApplication.h>
 
+#include "services/rootfile/ThreadHistogram_service.h"
+
 class TrackingOccupancyAnalysis {
 
 public:
@@ -29,11 +31,11 @@ private:
     };
 
     /// Hits count histogram for each hits readout name
-    std::vector<std::shared_ptr<TH1F>> m_hits_count_hists;
+    std::vector<ThreadHistogram<TH1F>> m_hits_count_hists;
 
     /// Hits occupancy histogram for each hits readout name
-    std::vector<std::shared_ptr<TH2F>> m_hits_occup_hists;
+    std::vector<ThreadHistogram<TH2F>> m_hits_occup_hists;
 
     /// Total occupancy of all m_data_names
-    TH2F * m_total_occup_th2;                 /// MC Particles px,py
+    ThreadHistogram<TH2F> m_total_occup_th2;
 };
@@ -27,6 +27,7 @@
 #include "algorithms/tracking/ParticlesFromTrackFitResult.h"
 #include "algorithms/tracking/JugTrack/Track.hpp"
 #include "services/rootfile/RootFile_service.h"
+#include "services/rootfile/ThreadHistogram_service.h"
 
 using namespace fmt;
 
@@ -55,7 +56,6 @@ void TrackingOccupancy_processor::Init()
     auto globalRootLock = app->GetService<JGlobalRootLock>();
     globalRootLock->acquire_write_lock();
     auto file = root_file_service->GetHistFile();
-    globalRootLock->release_lock();
 
     // Create a directory for this plugin. And subdirectories for series of histograms
     m_dir_main = file->mkdir(plugin_name.c_str());
@@ -63,6 +63,7 @@ void TrackingOccupancy_processor::Init()
     // Occupancy analysis
     m_occupancy_analysis.init(app, m_dir_main);
     m_hit_reco_analysis.init(app, m_dir_main);
+    globalRootLock->release_lock();
 
     // Get log level from user parameter or default
     std::string log_level_str = "info";
@@ -90,5 +91,6 @@ void TrackingOccupancy_processor::Process(const std::shared_ptr<const JEvent>& e
 //------------------
 void TrackingOccupancy_processor::Finish()
 {
-	// Nothing to do here
+    // Add up the histograms filled by each thread
+    GetApplication()->GetService<ThreadHistogram_service>()->Merge();
 }
@@ -114,6 +114,10 @@ extern "C" {
         app->Add(new JChainFactoryGeneratorT<Cluster_factory_EcalBarrelImagingClusters>(
           {"EcalBarrelImagingProtoClusters"}, "EcalBarrelImagingClusters"
         ));
+        JChainGraph::Instance().AddTags("EcalBarrelImagingClusters",
+          {"EcalBarrelImagingHits"},
+          {"EcalBarrelImagingClusterAssociations", "EcalBarrelImagingLayers"}
+        );
         app->Add(new JChainFactoryGeneratorT<Cluster_factory_EcalBarrelImagingMergedClusters>(
           {
             "MCParticles",
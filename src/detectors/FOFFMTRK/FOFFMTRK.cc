@@ -17,5 +17,6 @@ void InitPlugin(JApplication *app) {
     using namespace eicrecon;
 
     app->Add(new JFactoryGeneratorT<OffMomentumReconstruction_factory>());
+    JChainGraph::Instance().AddNode("OffMomentumReconstruction", {"ForwardOffMTrackerHits"}, {"ForwardOffMRecParticles"});
 }
 }
@@ -18,5 +18,6 @@ void InitPlugin(JApplication *app) {
 
 
     app->Add(new JFactoryGeneratorT<RomanPotsReconstruction_factory>());
+    JChainGraph::Instance().AddNode("RomanPotsReconstruction", {"ForwardRomanPotHits"}, {"ForwardRomanPotRecParticles"});
 }
 }
@@ -69,7 +69,7 @@ namespace eicrecon {
 
 	auto converter = m_geoSvc->cellIDPositionConverter();
 
-	auto rawhits =  event->Get<edm4hep::SimTrackerHit>("ForwardRomanPotHits");
+	auto rawhits =  event->Get<edm4hep::SimTrackerHit>(m_input_tag);
 
 
         //---- begin Roman Pot Reconstruction code ----
@@ -11,6 +11,8 @@
 #include <JANA/JFactoryGenerator.h>
 
 #include "JChainFactoryT.h"
+#include "JChainProfiler.h"
+#include "JChainScheduler.h"
 
 template<class FactoryT>
 class JChainFactoryGeneratorT : public JFactoryGenerator {
@@ -25,21 +27,26 @@ public:
             m_default_input_tags(std::move(default_input_tags)),
             m_output_tag(std::move(tag)),
             m_default_cfg(cfg)
-        {};
+        {
+            AddGraphNode();
+        };
 
     /// Constructor for NoConfig configuration
     explicit JChainFactoryGeneratorT(std::vector<std::string> default_input_tags, std::string tag):
             m_default_input_tags(std::move(default_input_tags)),
             m_output_tag(std::move(tag))
-    {};
+    {
+        AddGraphNode();
+    };
 
     void GenerateFactories(JFactorySet *factory_set) override {
+        if (!eicrecon::JChainGraph::Instance().IsNeeded(japp, {m_output_tag})) return;
 
         FactoryT *factory;
         if constexpr(std:: is_base_of<NoConfig,FactoryConfigType>()) {
-            factory = new FactoryT(m_default_input_tags);
+            factory = new eicrecon::JChainProfiledT<FactoryT>(m_default_input_tags);
         } else {
-            factory = new FactoryT(m_default_input_tags, m_default_cfg);
+            factory = new eicrecon::JChainProfiledT<FactoryT>(m_default_input_tags, m_default_cfg);
         }
 
 
@@ -53,7 +60,23 @@ public:
     std::vector<std::string>& GetDefaultInputTags() { return m_default_input_tags; }
 
 private:
+    void AddGraphNode() {
+        m_graph_node = eicrecon::JChainGraph::Instance().AddNode(m_output_tag, m_default_input_tags, {m_output_tag},
+                                                                 [this] () { ResolveInputTags(); });
+    }
+
+    /// The factory replaces the default input tags by the <plugin>:<tag>:InputTags parameter
+    /// (see JChainFactoryT::InitDataTags), once it is made; the graph needs them before
+    void ResolveInputTags() {
+        auto param = this->GetPluginName() + ":" + m_output_tag + ":InputTags";
+        if (!japp->GetJParameterManager()->Exists(param)) return;
+        auto input_tags = japp->GetParameterValue<std::vector<std::string>>(param);
+        if (input_tags.empty()) return;
+        eicrecon::JChainGraph::Instance().SetNode(m_graph_node, m_output_tag, input_tags, {m_output_tag});
+    }
+
     std::string m_output_tag;
     std::vector<std::string> m_default_input_tags;
     FactoryConfigType m_default_cfg;                   /// Default config for a factories. (!) Must be properly copyable
+    std::size_t m_graph_node;
 };
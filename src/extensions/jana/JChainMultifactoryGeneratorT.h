@@ -4,12 +4,15 @@
 
 #pragma once
 
+#include <mutex>
 #include <vector>
 
 #include <JANA/JFactorySet.h>
 #include <JANA/JFactoryGenerator.h>
 
 #include "JChainMultifactoryT.h"
+#include "JChainProfiler.h"
+#include "JChainScheduler.h"
 
 template<class FactoryT>
 class JChainMultifactoryGeneratorT : public JFactoryGenerator {
@@ -25,7 +28,9 @@ public:
             m_default_input_tags(std::move(default_input_tags)),
             m_default_output_tags(std::move(output_tags)),
             m_default_cfg(cfg),
-            m_app(app)
+            m_app(app),
+            m_graph_node(eicrecon::JChainGraph::Instance().AddNode(m_tag, m_default_input_tags, m_default_output_tags,
+                                                                   [this] () { InitOnce(); }))
     {
     };
 
@@ -34,22 +39,21 @@ public:
             m_tag(tag),
             m_default_input_tags(std::move(default_input_tags)),
             m_default_output_tags(std::move(output_tags)),
-            m_app(app)
+            m_app(app),
+            m_graph_node(eicrecon::JChainGraph::Instance().AddNode(m_tag, m_default_input_tags, m_default_output_tags,
+                                                                   [this] () { InitOnce(); }))
     {
     };
 
     void GenerateFactories(JFactorySet *factory_set) override {
-        // initialization is delayed to let caller set plugin name first
-        if (!m_init_done) {
-            Init();
-            m_init_done = true;
-        }
+        InitOnce();
+        if (!eicrecon::JChainGraph::Instance().IsNeeded(m_app, m_output_tags)) return;
 
         FactoryT *factory;
         if constexpr(std:: is_base_of<NoConfig,FactoryConfigType>()) {
-            factory = new FactoryT(m_tag, m_input_tags, m_output_tags);
+            factory = new eicrecon::JChainProfiledT<FactoryT>(m_tag, m_input_tags, m_output_tags);
         } else {
-            factory = new FactoryT(m_tag, m_input_tags, m_output_tags, m_default_cfg);
+            factory = new eicrecon::JChainProfiledT<FactoryT>(m_tag, m_input_tags, m_output_tags, m_default_cfg);
         }
         factory->SetPrefix(m_prefix);
         factory->SetFactoryName(JTypeInfo::demangle<FactoryT>());
@@ -59,6 +63,12 @@ public:
     }
 
 
+    /// Initialization is delayed to let caller set plugin name first. Called by the first
+    /// GenerateFactories, or by the graph, which needs the tags before
+    void InitOnce() {
+        std::call_once(m_init_flag, [this] () { Init(); });
+    }
+
     void Init() {
         std::string plugin_name = this->GetPluginName();
         m_prefix = plugin_name + ":" + m_tag;
@@ -73,6 +83,8 @@ public:
         if(m_output_tags.empty()) {
             m_output_tags = m_default_output_tags;
         }
+
+        eicrecon::JChainGraph::Instance().SetNode(m_graph_node, m_prefix, m_input_tags, m_output_tags);
     }
 
 
@@ -86,5 +98,6 @@ private:
 
     FactoryConfigType m_default_cfg;                   /// Default config for a factories. (!) Must be properly copyable
     JApplication* m_app; // TODO: NWB: Remove me
-    bool m_init_done = false;
+    std::once_flag m_init_flag;
+    std::size_t m_graph_node;
 };
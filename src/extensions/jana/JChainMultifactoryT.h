@@ -78,6 +78,23 @@ public:
     std::string& GetPrefix() { return m_prefix; }
 
 
+    /// Sets an output collection, counting its objects for profiling (see JChainProfiler.h)
+    template <typename T>
+    void SetCollection(std::string tag, typename PodioTypeMap<T>::collection_t&& collection) {
+        m_num_output_objects += collection.size();
+        JMultifactory::SetCollection<T>(std::move(tag), std::move(collection));
+    }
+
+    template <typename T>
+    void SetCollection(std::string tag, std::unique_ptr<typename PodioTypeMap<T>::collection_t> collection) {
+        m_num_output_objects += collection->size();
+        JMultifactory::SetCollection<T>(std::move(tag), std::move(collection));
+    }
+
+    /// Total number of objects in all output collections set so far
+    std::size_t GetNumOutputObjects() const { return m_num_output_objects; }
+
+
 protected:
 
     /// Underlying algorithm config
@@ -101,4 +118,6 @@ private:
     JApplication* m_app;
     std::string m_plugin_name;
 
+    std::size_t m_num_output_objects = 0;
+
 };
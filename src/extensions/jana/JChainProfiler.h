@@ -0,0 +1,262 @@
+// Copyright 2023, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+
+/**
+ * Per-factory profiling of JChain factories
+ *
+ * JChainFactoryGeneratorT and JChainMultifactoryGeneratorT create each factory as
+ * JChainProfiledT<FactoryT>, which measures the calls of FactoryT::Process, if enabled
+ * with -Peicrecon:profile_factories=1 (or =2 to also measure the heap).
+ *
+ * Each factory instance (JANA makes one per event in flight, and runs it on one thread
+ * at a time) has its own counters, so no locking is needed while processing. Once all
+ * profiled instances are finished, the counters are summed per factory, and a table
+ * ranked by total wall time is printed, and written as JSON to the file
+ * eicrecon:profile_factories_json.
+ *
+ * If the trace plugin is loaded, each call is also recorded as a span (see Trace_service.h).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define EICRECON_HAVE_MALLINFO2
+#endif
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+#include <JANA/JMultifactory.h>
+
+#include "services/log/Log_service.h"
+#include "services/trace/Trace_service.h"
+
+namespace eicrecon {
+
+class JChainProfiler {
+public:
+
+    /// Counters of one factory instance
+    struct Counters {
+        std::string name;
+        std::size_t calls      = 0;
+        double      wall_time  = 0;  /// [s]
+        double      cpu_time   = 0;  /// [s], of the calling thread
+        std::size_t objects    = 0;  /// number of output objects
+        long long   heap_bytes = 0;  /// growth of the heap in use; approximate if other threads allocate concurrently
+    };
+
+    /// Measures one call, adding to `counters` when it goes out of scope
+    class Probe {
+    public:
+        Probe(Counters* counters, bool measure_heap):
+                m_counters(counters),
+                m_measure_heap(measure_heap),
+                m_wall_start(std::chrono::steady_clock::now()),
+                m_cpu_start(CpuTime()),
+                m_heap_start(measure_heap ? HeapInUse() : 0) {}
+
+        ~Probe() {
+            m_counters->calls++;
+            m_counters->wall_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_wall_start).count();
+            m_counters->cpu_time  += CpuTime() - m_cpu_start;
+            if (m_measure_heap) m_counters->heap_bytes += HeapInUse() - m_heap_start;
+        }
+
+    private:
+        Counters* m_counters;
+        bool m_measure_heap;
+        std::chrono::steady_clock::time_point m_wall_start;
+        double m_cpu_start;
+        long long m_heap_start;
+    };
+
+    static JChainProfiler& Instance() {
+        static JChainProfiler instance;
+        return instance;
+    }
+
+    /// Registers a factory instance; the returned counters are only updated by that instance
+    Counters* Register(JApplication* app, const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_log) {
+            m_log = app->GetService<Log_service>()->logger("JChainProfiler");
+            app->SetDefaultParameter("eicrecon:profile_factories_json", m_json_file, "File for the JSON factory profile report; empty for none");
+        }
+        m_counters.push_back(std::make_unique<Counters>());
+        m_counters.back()->name = name;
+        return m_counters.back().get();
+    }
+
+    /// Called once by each registered instance, when it is finished or destroyed; the report
+    /// is made when all registered instances are done
+    void Done() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (++m_num_done == m_counters.size()) Report();
+    }
+
+    /// Thread CPU time [s]
+    static double CpuTime() {
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return ts.tv_sec + 1e-9 * ts.tv_nsec;
+    }
+
+    /// Heap in use [bytes], or 0 if unknown
+    static long long HeapInUse() {
+#ifdef EICRECON_HAVE_MALLINFO2
+        return static_cast<long long>(mallinfo2().uordblks);
+#else
+        return 0;
+#endif
+    }
+
+private:
+    JChainProfiler() = default;
+
+    void Report() {
+        // sum the instances of each factory, and rank by total wall time
+        std::map<std::string, Counters> totals;
+        std::map<std::string, std::size_t> num_instances;
+        for (const auto& c : m_counters) {
+            auto& total = totals[c->name];
+            total.name        = c->name;
+            total.calls      += c->calls;
+            total.wall_time  += c->wall_time;
+            total.cpu_time   += c->cpu_time;
+            total.objects    += c->objects;
+            total.heap_bytes += c->heap_bytes;
+            num_instances[c->name]++;
+        }
+        std::vector<Counters> ranked;
+        double wall_time_sum = 0;
+        for (auto& [name, total] : totals) {
+            ranked.push_back(total);
+            wall_time_sum += total.wall_time;
+        }
+        std::sort(ranked.begin(), ranked.end(), [] (const Counters& a, const Counters& b) { return a.wall_time > b.wall_time; });
+        auto per_call = [] (auto value, std::size_t calls) { return calls > 0 ? static_cast<double>(value) / calls : 0.0; };
+
+        // table
+        m_log->info("Factory profile ({} factories, {:.3f} s total):", ranked.size(), wall_time_sum);
+        m_log->info("  {:>4}  {:<60} {:>9} {:>10} {:>6} {:>12} {:>12} {:>12} {:>14}",
+                    "rank", "factory", "calls", "wall [s]", "[%]", "wall/call", "cpu/call", "objects/call", "heap/call");
+        m_log->info("  {:>4}  {:<60} {:>9} {:>10} {:>6} {:>12} {:>12} {:>12} {:>14}",
+                    "", "", "", "", "", "[ms]", "[ms]", "", "[kB]");
+        for (std::size_t i = 0; i < ranked.size(); i++) {
+            const auto& c = ranked[i];
+            m_log->info("  {:>4}  {:<60} {:>9} {:>10.3f} {:>6.1f} {:>12.3f} {:>12.3f} {:>12.1f} {:>14.1f}",
+                        i + 1, c.name, c.calls, c.wall_time,
+                        wall_time_sum > 0 ? 100 * c.wall_time / wall_time_sum : 0.0,
+                        1e3 * per_call(c.wall_time, c.calls),
+                        1e3 * per_call(c.cpu_time, c.calls),
+                        per_call(c.objects, c.calls),
+                        per_call(c.heap_bytes, c.calls) / 1024);
+        }
+
+        // JSON
+        if (m_json_file.empty()) return;
+        std::ofstream json(m_json_file);
+        if (!json) {
+            m_log->error("Cannot write factory profile to '{}'", m_json_file);
+            return;
+        }
+        json << "{\n  \"factories\": [\n";
+        for (std::size_t i = 0; i < ranked.size(); i++) {
+            const auto& c = ranked[i];
+            json << fmt::format(
+                    "    {{\"name\": \"{}\", \"instances\": {}, \"calls\": {}, \"wall_time_s\": {}, \"cpu_time_s\": {}, \"objects\": {}, \"heap_bytes\": {}}}{}\n",
+                    c.name, num_instances[c.name], c.calls, c.wall_time, c.cpu_time, c.objects, c.heap_bytes,
+                    i + 1 < ranked.size() ? "," : "");
+        }
+        json << "  ]\n}\n";
+        m_log->info("Factory profile written to '{}'", m_json_file);
+    }
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<Counters>> m_counters;
+    std::size_t m_num_done = 0;
+    std::shared_ptr<spdlog::logger> m_log;
+    std::string m_json_file = "factory_profile.json";
+};
+
+
+/// Profiling wrapper of a JChain factory; see JChainProfiler
+template <typename FactoryT>
+class JChainProfiledT : public FactoryT {
+public:
+    using FactoryT::FactoryT;
+
+    ~JChainProfiledT() { Done(); }
+
+    void Process(const std::shared_ptr<const JEvent>& event) override {
+        if (m_level < 0) InitProfiling(event);
+        Trace_service::Span span(m_trace_name, "factory", event->GetEventNumber());
+        if (m_level == 0) {
+            FactoryT::Process(event);
+            return;
+        }
+        auto objects_before = NumOutputObjects();
+        {
+            JChainProfiler::Probe probe(m_counters, m_level >= 2);
+            FactoryT::Process(event);
+        }
+        m_counters->objects += NumOutputObjects() - objects_before;
+    }
+
+    void Finish() override {
+        FactoryT::Finish();
+        Done();
+    }
+
+private:
+
+    void InitProfiling(const std::shared_ptr<const JEvent>& event) {
+        auto app = event->GetJApplication();
+        int level = 0;
+        app->SetDefaultParameter("eicrecon:profile_factories", level, "Profile JChain factories: 0 = off, 1 = time and output objects, 2 = also the heap");
+        std::string name;
+        if constexpr (std::is_base_of_v<JMultifactory, FactoryT>)
+            name = this->GetPrefix();
+        else
+            name = this->GetPluginName() + ":" + this->GetTag();
+        if (level > 0) m_counters = JChainProfiler::Instance().Register(app, name);
+        m_trace_name = Trace_service::NameId(name);
+        m_level = level;
+    }
+
+    /// Number of output objects so far
+    std::size_t NumOutputObjects() {
+        if constexpr (std::is_base_of_v<JMultifactory, FactoryT>)
+            return this->GetNumOutputObjects();
+        else
+            return this->mData.size();
+    }
+
+    void Done() {
+        if (m_counters != nullptr && !m_done) {
+            m_done = true;
+            JChainProfiler::Instance().Done();
+        }
+    }
+
+    int m_level = -1;  /// profiling level; -1 until the first event
+    bool m_done = false;
+    JChainProfiler::Counters* m_counters = nullptr;
+    std::uint32_t m_trace_name = 0;
+};
+
+} // namespace eicrecon
@@ -0,0 +1,335 @@
+// Copyright 2023, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+
+/**
+ * Concurrent execution of the JChain factories of one event
+ *
+ * JANA runs factories lazily: a factory runs when its output is first requested, on
+ * the thread that requested it, so independent chains (e.g. the calorimeters and the
+ * tracking) of an event run one after the other. JChainGraph collects the input and
+ * output tags of all factories made by JChainFactoryGeneratorT and
+ * JChainMultifactoryGeneratorT, with the tags set by parameters. From it,
+ * JChainScheduler plans which factories are needed for a set of collections, and runs
+ * them on a pool of threads shared by all events, each factory as soon as the factories
+ * making its inputs are done. The graph also lets the generators skip factories that no
+ * requested collection depends on (see JChainGraph::IsNeeded). Plugins add the factories
+ * made otherwise, and the collections that factories request or insert by fixed names,
+ * with AddNode and AddTags.
+ *
+ * Requirements: a factory must only request the collections named by its input tags
+ * (or collections already made before Run), and JANA call graph recording must be off,
+ * since factories of the same event now run concurrently.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+
+#include "services/log/Log_service.h"
+
+namespace eicrecon {
+
+/// Input and output tags of all JChain factories
+class JChainGraph {
+public:
+
+    struct Node {
+        std::string name;
+        std::vector<std::string> inputs;
+        std::vector<std::string> outputs;
+    };
+
+    static JChainGraph& Instance() {
+        static JChainGraph instance;
+        return instance;
+    }
+
+    /// Called once per factory generator, when it is made; returns the index of the node.
+    /// `resolve_tags` is called before the nodes are first used, once all plugins are
+    /// loaded, to replace the default tags by the ones set by parameters (see SetNode)
+    std::size_t AddNode(std::string name, std::vector<std::string> inputs, std::vector<std::string> outputs,
+                        std::function<void()> resolve_tags = {}) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nodes.push_back({std::move(name), std::move(inputs), std::move(outputs)});
+        if (resolve_tags) m_resolve_tags.push_back(std::move(resolve_tags));
+        return m_nodes.size() - 1;
+    }
+
+    /// Declares further inputs and outputs of the factory making `output`, for factories
+    /// that request or insert collections by fixed names besides their tags
+    void AddTags(std::string output, std::vector<std::string> inputs, std::vector<std::string> outputs) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_extra_tags.push_back({std::move(output), std::move(inputs), std::move(outputs)});
+    }
+
+    /// Replaces the name and tags of a node, e.g. once its tag parameters are read
+    void SetNode(std::size_t index, std::string name, std::vector<std::string> inputs, std::vector<std::string> outputs) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nodes.at(index) = {std::move(name), std::move(inputs), std::move(outputs)};
+    }
+
+    std::vector<Node> GetNodes() {
+        std::call_once(m_resolved_flag, [this] () {
+            std::vector<std::function<void()>> resolve_tags;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                resolve_tags.swap(m_resolve_tags);
+            }
+            for (const auto& resolve : resolve_tags) resolve();
+        });
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto nodes = m_nodes;
+        for (const auto& extra : m_extra_tags) {
+            for (auto& node : nodes) {
+                if (std::find(node.outputs.begin(), node.outputs.end(), extra.name) == node.outputs.end()) continue;
+                node.inputs.insert(node.inputs.end(), extra.inputs.begin(), extra.inputs.end());
+                node.outputs.insert(node.outputs.end(), extra.outputs.begin(), extra.outputs.end());
+            }
+        }
+        return nodes;
+    }
+
+    /// False if -Peicrecon:lazy_factories=1 and none of `outputs` is needed, directly or
+    /// through other chain factories, for the collections written or printed by the podio
+    /// writer, or listed in eicrecon:lazy_extra_collections. Generators skip factories that
+    /// are not needed. Call from GenerateFactories, when all plugins have added their generators
+    bool IsNeeded(JApplication* app, const std::vector<std::string>& outputs) {
+        std::call_once(m_needed_flag, [this, app] () { FindNeededCollections(app); });
+        if (!m_lazy) return true;
+        for (const auto& output : outputs) {
+            if (m_needed.count(output) > 0) return true;
+        }
+        return false;
+    }
+
+    /// True if -Peicrecon:lazy_factories=1 took effect. Valid once IsNeeded was called
+    bool IsLazy() const { return m_lazy; }
+
+private:
+    JChainGraph() = default;
+
+    void FindNeededCollections(JApplication* app) {
+        app->SetDefaultParameter("eicrecon:lazy_factories", m_lazy, "Only create the JChain factories needed for the collections written or printed by the podio writer, and for eicrecon:lazy_extra_collections");
+        if (!m_lazy) return;
+
+        std::vector<std::string> requested;
+        app->SetDefaultParameter("eicrecon:lazy_extra_collections", requested, "Collections needed by other than the podio writer, e.g. by monitoring plugins or by factories missing from the JChain graph, with -Peicrecon:lazy_factories=1");
+        auto log = app->GetService<Log_service>()->logger("JChainGraph");
+        auto params = app->GetJParameterManager();
+        // without an include list, the podio writer writes all collections
+        if (!params->Exists("podio:output_include_collections") ||
+            app->GetParameterValue<std::vector<std::string>>("podio:output_include_collections").empty()) {
+            log->warn("eicrecon:lazy_factories needs podio:output_include_collections; all factories are created");
+            m_lazy = false;
+            return;
+        }
+        for (const auto& param : {"podio:output_include_collections", "podio:print_collections"}) {
+            if (!params->Exists(param)) continue;
+            auto collections = app->GetParameterValue<std::vector<std::string>>(param);
+            requested.insert(requested.end(), collections.begin(), collections.end());
+        }
+
+        auto nodes = GetNodes();
+        std::map<std::string, std::size_t> producers;
+        for (std::size_t i = 0; i < nodes.size(); i++) {
+            for (const auto& output : nodes[i].outputs) producers.emplace(output, i);
+        }
+        std::set<std::size_t> needed_nodes;
+        while (!requested.empty()) {
+            auto it = producers.find(requested.back());
+            requested.pop_back();
+            if (it == producers.end() || !needed_nodes.insert(it->second).second) continue;
+            const auto& node = nodes[it->second];
+            m_needed.insert(node.outputs.begin(), node.outputs.end());
+            requested.insert(requested.end(), node.inputs.begin(), node.inputs.end());
+        }
+        log->info("Lazy factories: creating {} of {} JChain factories", needed_nodes.size(), nodes.size());
+    }
+
+    mutable std::mutex m_mutex;
+    std::vector<Node> m_nodes;
+    std::vector<Node> m_extra_tags;   /// named by the output of the node they extend
+    std::vector<std::function<void()>> m_resolve_tags;
+    std::once_flag m_resolved_flag;
+
+    std::once_flag m_needed_flag;
+    bool m_lazy = false;
+    std::set<std::string> m_needed;   /// outputs of the needed factories
+};
+
+
+class JChainScheduler {
+public:
+
+    JChainScheduler() = default;
+    JChainScheduler(const JChainScheduler&) = delete;
+    JChainScheduler& operator=(const JChainScheduler&) = delete;
+
+    ~JChainScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto& thread : m_threads) thread.join();
+    }
+
+    /// Plan making `collections`: the chain factories that make them, directly or
+    /// through their inputs, and start `num_threads` threads running them for all
+    /// events. Call once, before Run
+    void Plan(const std::vector<std::string>& collections, std::size_t num_threads) {
+        auto graph_nodes = JChainGraph::Instance().GetNodes();
+        std::map<std::string, std::size_t> producers;
+        for (std::size_t i = 0; i < graph_nodes.size(); i++) {
+            for (const auto& output : graph_nodes[i].outputs) producers.emplace(output, i);
+        }
+
+        // collect the needed factories, walking up from the requested collections
+        std::map<std::size_t, std::size_t> plan_index;   // graph node -> m_nodes index
+        std::set<std::string> external_inputs;
+        std::vector<std::size_t> pending;
+        auto request = [&] (const std::string& collection, bool is_input) {
+            auto it = producers.find(collection);
+            if (it == producers.end()) {
+                if (is_input) external_inputs.insert(collection);
+                return;
+            }
+            if (plan_index.count(it->second) > 0) return;
+            plan_index[it->second] = m_nodes.size();
+            m_nodes.push_back({graph_nodes[it->second].outputs.front(), {}, 0});
+            pending.push_back(it->second);
+        };
+        for (const auto& collection : collections) request(collection, false);
+        while (!pending.empty()) {
+            auto i = pending.back();
+            pending.pop_back();
+            for (const auto& input : graph_nodes[i].inputs) request(input, true);
+        }
+
+        // dependencies between the planned factories
+        for (const auto& [graph_node, node] : plan_index) {
+            std::set<std::size_t> producer_nodes;
+            for (const auto& input : graph_nodes[graph_node].inputs) {
+                auto it = producers.find(input);
+                if (it != producers.end()) producer_nodes.insert(plan_index.at(it->second));
+            }
+            producer_nodes.erase(node);
+            for (auto producer : producer_nodes) m_nodes[producer].dependents.push_back(node);
+            m_nodes[node].num_dependencies = producer_nodes.size();
+        }
+        m_external_inputs.assign(external_inputs.begin(), external_inputs.end());
+
+        for (std::size_t i = 0; i < num_threads; i++) m_threads.emplace_back([this] { RunTasks(); });
+    }
+
+    std::size_t GetNumPlannedFactories() const { return m_nodes.size(); }
+
+    /// Run the planned factories for `event` on the threads of the scheduler, which are
+    /// shared by all events, and on the calling thread, returning when they are done.
+    /// Exceptions of factories are not reported here: the factory will throw again when
+    /// its output is requested
+    void Run(const JEvent& event) {
+
+        // Inputs from the source or from other factories are made first, on this
+        // thread, so that the tasks only read them
+        for (const auto& input : m_external_inputs) Trigger(event, input);
+
+        EventRun run{event, std::vector<std::size_t>(m_nodes.size()), m_nodes.size()};
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (std::size_t i = 0; i < m_nodes.size(); i++) {
+            run.num_waiting[i] = m_nodes[i].num_dependencies;
+            if (run.num_waiting[i] == 0) m_ready.push_back({&run, i});
+        }
+        m_cv.notify_all();
+
+        // help with the factories of this event, until all of them are done
+        while (run.num_left > 0) {
+            auto task = std::find_if(m_ready.begin(), m_ready.end(), [&run] (const Task& t) { return t.run == &run; });
+            if (task == m_ready.end()) {
+                m_cv.wait(lock);
+                continue;
+            }
+            auto node = task->node;
+            m_ready.erase(task);
+            RunTask(lock, run, node);
+        }
+    }
+
+private:
+
+    struct Node {
+        std::string trigger;                  /// an output collection, requested to run the factory
+        std::vector<std::size_t> dependents;  /// factories using its outputs
+        std::size_t num_dependencies;         /// number of factories making its inputs
+    };
+
+    /// Factories of one event being run
+    struct EventRun {
+        const JEvent& event;
+        std::vector<std::size_t> num_waiting;  /// number of factories making its inputs not yet done
+        std::size_t num_left;                  /// factories not yet done
+    };
+
+    /// A factory ready to run
+    struct Task {
+        EventRun* run;
+        std::size_t node;
+    };
+
+    /// Loop of the threads of the scheduler
+    void RunTasks() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_cv.wait(lock, [this] { return m_stop || !m_ready.empty(); });
+            if (m_stop) break;
+            auto task = m_ready.front();
+            m_ready.pop_front();
+            RunTask(lock, *task.run, task.node);
+        }
+    }
+
+    /// Runs the factory, unlocking `lock` meanwhile, and queues the factories it makes ready
+    void RunTask(std::unique_lock<std::mutex>& lock, EventRun& run, std::size_t node) {
+        lock.unlock();
+        Trigger(run.event, m_nodes[node].trigger);
+        lock.lock();
+        for (auto dependent : m_nodes[node].dependents) {
+            if (--run.num_waiting[dependent] == 0) m_ready.push_back({&run, dependent});
+        }
+        run.num_left--;   // once zero, `run` may be gone as soon as `lock` is released
+        m_cv.notify_all();
+    }
+
+    static void Trigger(const JEvent& event, const std::string& collection) {
+        try {
+            event.GetCollectionBase(collection);
+        }
+        catch (...) {
+            // reported by whoever requests the collection later
+        }
+    }
+
+    std::vector<Node> m_nodes;
+    std::vector<std::string> m_external_inputs;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Task> m_ready;       /// of all events
+    bool m_stop = false;
+    std::vector<std::thread> m_threads;
+};
+
+} // namespace eicrecon
@@ -0,0 +1,72 @@
+// Copyright 2023, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+
+/**
+ * Admission control of events read by event sources
+ *
+ * An optional plugin (e.g. memory, see MemoryGovernor_service.h) registers a
+ * JEventAdmission, and event sources ask it to admit each event before inserting it
+ * into the JEvent, so the sources do not depend on the plugin:
+ *
+ *     if (auto admission = eicrecon::JEventAdmission::Get()) {
+ *         auto ticket = admission->TryAdmit(cost);
+ *         if (!ticket) { ...keep the event...; throw RETURN_STATUS::kTRY_AGAIN; }
+ *         event->Insert(ticket.release());
+ *     }
+ *
+ * TryAdmit never blocks: a source must not wait in GetEvent, as the events in flight
+ * may only finish on the thread that would wait (e.g. with -Pnthreads=1). A source
+ * keeps a refused event and offers it again on the next call of GetEvent, while JANA
+ * runs the events in flight in the meantime.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+namespace eicrecon {
+
+/// Held by an admitted event while it is in flight; inserted into the JEvent, so that
+/// it is destroyed, ending the admission, when JANA recycles the event
+class JEventAdmissionTicket {
+public:
+    virtual ~JEventAdmissionTicket() = default;
+};
+
+
+class JEventAdmission {
+public:
+    virtual ~JEventAdmission() = default;
+
+    /// Admits an event costing `cost` (e.g. its number of simulated hits), or returns
+    /// nullptr, without waiting, if it cannot be admitted now
+    virtual std::unique_ptr<JEventAdmissionTicket> TryAdmit(std::size_t cost) = 0;
+
+    /// The registered admission control, or nullptr if no plugin registered one
+    static std::shared_ptr<JEventAdmission> Get() {
+        std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+        return GetRegistry().admission;
+    }
+
+    /// Registers the admission control used by all event sources; nullptr to remove it
+    static void Register(std::shared_ptr<JEventAdmission> admission) {
+        std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+        GetRegistry().admission = std::move(admission);
+    }
+
+private:
+
+    struct Registry {
+        std::mutex mutex;
+        std::shared_ptr<JEventAdmission> admission;
+    };
+
+    static Registry& GetRegistry() {
+        static Registry registry;
+        return registry;
+    }
+};
+
+} // namespace eicrecon
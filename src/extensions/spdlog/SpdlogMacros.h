@@ -0,0 +1,29 @@
+// Copyright 2023, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+/** Logging that costs nothing when the level is disabled
+ *
+ * spdlog checks the level before formatting a message, but the arguments of
+ * m_log->debug(...) are still evaluated. These macros check the level first, so
+ * that the arguments are only evaluated if the message is printed. Use them in
+ * per-hit or per-track loops, and guard blocks of messages with EICRECON_LOG_ENABLED.
+ *
+ * @example:
+ *      EICRECON_DEBUG(m_log, "hit radius = {}", std::hypot(pos.x, pos.y));
+ *
+ *      if (EICRECON_LOG_ENABLED(m_log, trace)) {
+ *          for (const auto& hit: hits) m_log->trace("{}: {}", hit.getCellID(), hit.getEnergy());
+ *      }
+ */
+#define EICRECON_LOG_ENABLED(logger, lvl) ((logger)->should_log(spdlog::level::lvl))
+
+#define EICRECON_LOG(logger, lvl, ...) \
+    do { if (EICRECON_LOG_ENABLED(logger, lvl)) (logger)->log(spdlog::level::lvl, __VA_ARGS__); } while (0)
+
+#define EICRECON_TRACE(logger, ...) EICRECON_LOG(logger, trace, __VA_ARGS__)
+#define EICRECON_DEBUG(logger, ...) EICRECON_LOG(logger, debug, __VA_ARGS__)
@@ -53,6 +53,14 @@ void eicrecon::PhotoMultiplierHitDigi_factory::Init() {
     m_digi_algo.SetVisitRngCellIDs(
         [readoutGeo = this->m_readoutGeo] (std::function<void(uint64_t)> lambda, float p) { readoutGeo->VisitAllRngPixels(lambda, p); }
         );
+    m_digi_algo.SetPixelLookup(
+        [readoutGeo = this->m_readoutGeo] (uint64_t id) { return readoutGeo->GetPixel(id); }
+        );
+    if(m_readoutGeo->HasPixelTable())
+      m_digi_algo.SetNoisePixels(
+          m_readoutGeo->GetNumReadoutPixels(),
+          [readoutGeo = this->m_readoutGeo] (std::size_t i) -> const richgeo::ReadoutGeo::Pixel& { return readoutGeo->GetReadoutPixel(i); }
+          );
   }
 }
 
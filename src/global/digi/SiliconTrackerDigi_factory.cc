@@ -66,5 +66,5 @@ void eicrecon::SiliconTrackerDigi_factory::Process(const std::shared_ptr<const J
 
     // RUN algorithm
     auto digitised_hits = m_digi_algo.produce(total_sim_hits);  // Digitize hits
-    this->Set(digitised_hits);                                                       // Add data as a factory output
+    SetCollection(std::move(digitised_hits));                   // Add data as a factory output
 }
@@ -25,6 +25,8 @@ void eicrecon::IrtCherenkovParticleID_factory::Init() {
   };
   set_param("numRIndexBins", cfg.numRIndexBins, "");
   set_param("pdgList",       cfg.pdgList,       "");
+  set_param("fiducialCut",    cfg.fiducialCut,    "only use sensor hits within the expected ring footprint of each track");
+  set_param("fiducialMargin", cfg.fiducialMargin, "angular margin added to the maximum Cherenkov angle for the fiducial cut [rad]");
   for(auto& [name,rad] : cfg.radiators) {
     set_param(name+":smearingMode",    rad.smearingMode,    "");
     set_param(name+":smearing",        rad.smearing,        "");
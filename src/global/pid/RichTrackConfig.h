@@ -15,6 +15,12 @@ namespace eicrecon {
       //   NOTE: some defaults are hard-coded here; override externally
 
       std::map <std::string,unsigned> numPlanes; // number of xy-planes for track projections (for each radiator)
+      /* acceptance cut: skip the propagation of trajectories outside of each radiator's eta range,
+       * estimated from straight lines from the origin; rejected trajectories get an empty
+       * `TrackSegment`, so this is off by default, as it may drop low-momentum or displaced tracks
+       */
+      bool   acceptanceCut    = false; // if true, do not propagate trajectories outside of each radiator's (eta,phi) acceptance
+      double acceptanceMargin = 0.2;   // eta margin added to each side of the acceptance
 
       //
       /////////////////////////////////////////////////////
@@ -29,6 +35,8 @@ namespace eicrecon {
         m_log->log(lvl, "{:=^60}"," RichTrackConfig Settings ");
         for(const auto& [rad,val] : numPlanes)
           m_log->log(lvl, "  {:>20} = {:<}", fmt::format("{} numPlanes", rad), val);
+        m_log->log(lvl, "  {:>20} = {:<}", "acceptanceCut",    acceptanceCut);
+        m_log->log(lvl, "  {:>20} = {:<}", "acceptanceMargin", acceptanceMargin);
         m_log->log(lvl, "{:=^60}","");
       }
 
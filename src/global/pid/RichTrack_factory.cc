@@ -37,9 +37,12 @@ void eicrecon::RichTrack_factory::Init() {
   };
   for(auto& [radiator_id, radiator_name, output_tag] : radiator_list)
     set_param(radiator_name+":numPlanes", cfg.numPlanes[radiator_name], "");
+  set_param("acceptanceCut",    cfg.acceptanceCut,    "do not propagate trajectories outside of each radiator's straight-line eta acceptance; rejected trajectories get empty TrackSegments");
+  set_param("acceptanceMargin", cfg.acceptanceMargin, "eta margin added to each side of the acceptance");
   cfg.Print(m_log, spdlog::level::debug);
 
   // get RICH geometry for track propagation, for each radiator
+  // - the tracking planes are built once by `m_actsGeo`, and shared by all instances of this factory
   m_actsGeo = m_richGeoSvc->GetActsGeo(plugin);
   for(auto& [radiator_id, radiator_name, output_tag] : radiator_list) {
     m_tracking_planes.insert({
@@ -47,6 +50,10 @@ void eicrecon::RichTrack_factory::Init() {
         m_actsGeo->TrackingPlanes(radiator_id, cfg.numPlanes.at(radiator_name))
         });
     m_track_point_cuts.insert({ output_tag, m_actsGeo->TrackPointCut(radiator_id) });
+    if(cfg.acceptanceCut)
+      m_acceptance_cuts.insert({ output_tag, m_actsGeo->TrackAcceptance(radiator_id, cfg.numPlanes.at(radiator_name), cfg.acceptanceMargin) });
+    else
+      m_acceptance_cuts.insert({ output_tag, [] (double eta, double phi) { return true; } });
   }
 
 }
@@ -74,7 +81,8 @@ void eicrecon::RichTrack_factory::Process(const std::shared_ptr<const JEvent> &e
   for(auto& [output_tag, radiator_tracking_planes] : m_tracking_planes) {
     try {
       auto track_point_cut = m_track_point_cuts.at(output_tag);
-      auto result = m_propagation_algo.propagateToSurfaceList(trajectories, radiator_tracking_planes, track_point_cut, true);
+      auto acceptance_cut  = m_acceptance_cuts.at(output_tag);
+      auto result = m_propagation_algo.propagateToSurfaceList(trajectories, radiator_tracking_planes, track_point_cut, true, acceptance_cut);
       SetCollection<edm4eic::TrackSegment>(output_tag, std::move(result));
     }
     catch(std::exception &e) {
@@ -60,6 +60,8 @@ namespace eicrecon {
       std::map< std::string, std::vector<std::shared_ptr<Acts::Surface>> > m_tracking_planes;
       // map: output tag name -> cuts
       std::map< std::string, std::function<bool(edm4eic::TrackPoint)> > m_track_point_cuts;
+      // map: output tag name -> (eta,phi) acceptance cut
+      std::map< std::string, std::function<bool(double,double)> > m_acceptance_cuts;
 
 
       // underlying algorithm
@@ -32,7 +32,7 @@ namespace eicrecon {
     }
 
     void GeneratedJets_factory::Process(const std::shared_ptr<const JEvent> &event) {
-        auto mc_particles = event->Get<edm4hep::MCParticle>("MCParticles");
+        auto mc_particles = event->Get<edm4hep::MCParticle>(GetInputTags()[0]);
 
         std::vector<const edm4hep::LorentzVectorE*> momenta;
         for (const auto& p : mc_particles) {
@@ -28,18 +28,15 @@ namespace eicrecon {
 
         m_match_algo.init(m_log);
 
-        // Set up association tags
-        for (const std::string& input_tag : GetInputTags()) {
-            // "EcalEndcapNClusters" => "EcalEndcapNClusterAssociations"
-            auto pos = input_tag.find("Clusters");
-
-            // Validate that our input collection names conform to this convention
-            if (pos == std::string::npos) {
-                throw std::runtime_error(fmt::format("input_tag=\"{}\" doesn't end with \"Clusters\"", input_tag));
-            }
-            std::string output_tag = input_tag;
-            output_tag.replace(pos, 8, "ClusterAssociations");
-            m_input_assoc_tags.push_back(output_tag);
+        // Input tags: MC particles, charged particles and their associations, then
+        // pairs of clusters and their associations
+        auto& input_tags = GetInputTags();
+        if (input_tags.size() < 3 || (input_tags.size() - 3) % 2 != 0) {
+            throw std::runtime_error(fmt::format("expected 3 particle input tags followed by pairs of cluster and cluster association tags, got {}", input_tags.size()));
+        }
+        for (std::size_t i = 3; i < input_tags.size(); i += 2) {
+            m_input_cluster_tags.push_back(input_tags[i]);
+            m_input_assoc_tags.push_back(input_tags[i + 1]);
         }
     }
 
@@ -49,10 +46,9 @@ namespace eicrecon {
 
     void MatchClusters_factory::Process(const std::shared_ptr<const JEvent> &event) {
 
-        // TODO make input tags changeable
-        auto mc_particles = event->Get<edm4hep::MCParticle>("MCParticles");
-        auto charged_particles = event->Get<edm4eic::ReconstructedParticle>("ReconstructedChargedParticles");
-        auto charged_particle_assocs = event->Get<edm4eic::MCRecoParticleAssociation>("ReconstructedChargedParticleAssociations");
+        auto mc_particles = event->Get<edm4hep::MCParticle>(GetInputTags()[0]);
+        auto charged_particles = event->Get<edm4eic::ReconstructedParticle>(GetInputTags()[1]);
+        auto charged_particle_assocs = event->Get<edm4eic::MCRecoParticleAssociation>(GetInputTags()[2]);
 
         using ClustersVector = std::vector<const edm4eic::Cluster*>;
         using ClustersAssocVector = std::vector<const edm4eic::MCRecoClusterParticleAssociation*>;
@@ -60,7 +56,7 @@ namespace eicrecon {
         std::vector<ClustersVector> input_cluster_vectors;
         std::vector<ClustersAssocVector> input_cluster_assoc;
 
-        for(auto &input_tag: GetInputTags()) {
+        for(auto &input_tag: m_input_cluster_tags) {
             auto clusters = event->Get<edm4eic::Cluster>(input_tag);
             input_cluster_vectors.push_back(clusters);
 
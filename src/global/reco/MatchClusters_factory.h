@@ -38,6 +38,7 @@ namespace eicrecon {
         void Process(const std::shared_ptr<const JEvent> &event) override;
     protected:
 
+        std::vector<std::string> m_input_cluster_tags;
         std::vector<std::string> m_input_assoc_tags;
         MatchClusters m_match_algo;
 
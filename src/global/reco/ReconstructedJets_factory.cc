@@ -30,7 +30,7 @@ namespace eicrecon {
     }
 
     void ReconstructedJets_factory::Process(const std::shared_ptr<const JEvent> &event) {
-        auto rc_particles = event->Get<edm4eic::ReconstructedParticle>("ReconstructedParticles");
+        auto rc_particles = event->Get<edm4eic::ReconstructedParticle>(GetInputTags()[0]);
 
         std::vector<const edm4hep::LorentzVectorE*> momenta;
         for (const auto& p : rc_particles) {
@@ -33,9 +33,15 @@ void InitPlugin(JApplication *app) {
 
     app->Add(new JChainMultifactoryGeneratorT<MatchClusters_factory>(
         "ReconstructedParticlesWithAssoc",
-        { "EcalEndcapNClusters",
+        { "MCParticles",
+          "ReconstructedChargedParticles",
+          "ReconstructedChargedParticleAssociations",
+          "EcalEndcapNClusters",
+          "EcalEndcapNClusterAssociations",
           "EcalBarrelScFiClusters",
+          "EcalBarrelScFiClusterAssociations",
           "EcalEndcapPClusters",
+          "EcalEndcapPClusterAssociations",
         },
         { "ReconstructedParticles",           // edm4eic::ReconstructedParticle
           "ReconstructedParticleAssociations" // edm4eic::MCRecoParticleAssociation
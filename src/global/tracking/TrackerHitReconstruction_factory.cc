@@ -42,8 +42,9 @@ void TrackerHitReconstruction_factory::Process(const std::shared_ptr<const JEven
     // Get RawTrackerHit-s with the proper tag
     auto raw_hits = event->Get<edm4eic::RawTrackerHit>(GetInputTags()[0]);
 
-    // Output array
+    // Output array; the hits are owned by JANA once set, so they are not arena allocated
     std::vector<edm4eic::TrackerHit*> hits;
+    hits.reserve(raw_hits.size());
 
     try {
         // Create output hits using TrackerHitReconstruction algorithm
@@ -32,11 +32,17 @@ std::shared_ptr<const ActsGeometryProvider> ACTSGeo_service::actsGeoProvider() {
 
     try{
         std::call_once( init_flag, [this](){
-            // Assemble everything on the first call
-
+            // Assemble everything on the first call. This is also when the DD4hep
+            // geometry is loaded, if nothing else needed it before
+            m_dd4hepGeo = m_dd4hep_service->detector();
             if(!m_dd4hepGeo) {
                 throw JException("ACTSGeo_service m_dd4hepGeo==null which should never be!");
             }
+            // The tracking geometry is built from extensions of the detector elements,
+            // which DD4hep does not save in geometry snapshots
+            if(m_dd4hep_service->loadedFromSnapshot()) {
+                throw JException("ACTSGeo_service cannot build the tracking geometry from a geometry snapshot (dd4hep:snapshot), which lacks the DD4hep detector element extensions it needs. Run without -Pdd4hep:snapshot=1");
+            }
 
             // Get material map from user parameter
             // By default DD4Hep downloads material map to <run-dir>
@@ -76,7 +82,6 @@ void ACTSGeo_service::acquire_services(JServiceLocator * srv_locator) {
     m_init_log->set_level(eicrecon::ParseLogLevel(init_log_level_str));
     m_init_log->info("Acts INIT log level is set to {} ({})", log_level_str, m_init_log->level());
 
-    // DD4Hep geometry
-    auto dd4hep_service = srv_locator->get<JDD4hep_service>();
-    m_dd4hepGeo = dd4hep_service->detector();
+    // DD4Hep geometry, loaded on first use
+    m_dd4hep_service = srv_locator->get<JDD4hep_service>();
 }
@@ -32,6 +32,7 @@
 #include <DDRec/Surface.h>
 #include <DD4hep/DD4hepUnits.h>
 #include "algorithms/tracking/ActsGeometryProvider.h"
+#include "services/geometry/dd4hep/JDD4hep_service.h"
 
 
 class ACTSGeo_service : public JService
@@ -51,6 +52,7 @@ private:
 
     std::once_flag init_flag;
     JApplication *m_app = nullptr;
+    std::shared_ptr<JDD4hep_service> m_dd4hep_service;
     dd4hep::Detector* m_dd4hepGeo = nullptr;
     std::shared_ptr<ActsGeometryProvider> m_acts_provider;
 	//std::shared_ptr<const dd4hep::rec::CellIDPositionConverter> m_cellid_converter = nullptr;
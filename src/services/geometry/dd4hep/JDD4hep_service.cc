@@ -3,19 +3,70 @@
 //
 //
 
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <vector>
 #include <sstream>
 #include <algorithm>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <regex>
+#include <set>
+#include <unistd.h>
 #include <fmt/color.h>
 #include <fmt/format.h>
 
 #include "JDD4hep_service.h"
 
+#include <DD4hep/DD4hepRootPersistency.h>
 #include <DD4hep/Printout.h>
 
+namespace {
+
+    /// FNV-1a, which is stable across platforms and releases, unlike std::hash
+    void hashBytes(std::uint64_t &hash, const std::string &bytes) {
+        for (unsigned char c : bytes) {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    /// Replaces ${VAR} by the value of the environment variable VAR
+    std::string expandEnvironment(const std::string &str) {
+        static const std::regex env_regex(R"(\$\{([^}]+)\})");
+        std::string result;
+        std::size_t last = 0;
+        for (std::sregex_iterator it(str.begin(), str.end(), env_regex), end; it != end; ++it) {
+            result += str.substr(last, it->position() - last);
+            auto value = std::getenv((*it)[1].str().c_str());
+            if (value != nullptr) result += value;
+            last = it->position() + it->length();
+        }
+        return result + str.substr(last);
+    }
+
+    /// Adds the content of an XML file, and of the XML files it refers to, to the hash
+    void hashXmlFile(std::uint64_t &hash, const std::filesystem::path &path, std::set<std::string> &visited) {
+        if (!visited.insert(std::filesystem::weakly_canonical(path).string()).second) return;
+
+        std::ifstream file(path, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        hashBytes(hash, content);
+
+        // e.g. <include ref="${DETECTOR_PATH}/compact/definitions.xml"/>, relative paths are
+        // relative to the including file
+        static const std::regex ref_regex(R"re(ref\s*=\s*"([^"]+\.xml)")re");
+        for (std::sregex_iterator it(content.begin(), content.end(), ref_regex), end; it != end; ++it) {
+            std::filesystem::path ref_path(expandEnvironment((*it)[1].str()));
+            if (ref_path.is_relative()) ref_path = path.parent_path() / ref_path;
+            if (std::filesystem::exists(ref_path)) hashXmlFile(hash, ref_path, visited);
+        }
+    }
+
+}
+
 //----------------------------------------------------------------
 // destructor
 //----------------------------------------------------------------
@@ -87,6 +138,14 @@ void JDD4hep_service::Initialize() {
     int print_level = dd4hep::WARNING;
     app->SetDefaultParameter("dd4hep:print_level", print_level, "Set DD4hep print level (see DD4hep/Printout.h)");
 
+    // Parsing the XML files takes a long time. With dd4hep:snapshot, the constructed geometry
+    // is saved to a ROOT file the first time, and loaded from it by later jobs
+    bool use_snapshot = false;
+    app->SetDefaultParameter("dd4hep:snapshot", use_snapshot, "Load the geometry from a ROOT snapshot in dd4hep:snapshot_dir, which is made from the XML files by the first job using them. Snapshots lack detector element extensions, so they cannot be used with tracking (ACTS)");
+    auto home_env = std::getenv("HOME");
+    std::string snapshot_dir = home_env ? std::string(home_env) + "/.cache/eicrecon" : std::filesystem::temp_directory_path().string();
+    app->SetDefaultParameter("dd4hep:snapshot_dir", snapshot_dir, "Directory of the geometry snapshots made with dd4hep:snapshot");
+
     // Reading the geometry may take a long time and if the JANA ticker is enabled, it will keep printing
     // while no other output is coming which makes it look like something is wrong. Disable the ticker
     // while parsing and loading the geometry
@@ -97,19 +156,11 @@ void JDD4hep_service::Initialize() {
     try {
         dd4hep::setPrintLevel(static_cast<dd4hep::PrintLevel>(print_level));
         LOG << "Loading DD4hep geometry from " << m_xml_files.size() << " files" << LOG_END;
+        std::vector<std::string> resolved_filenames;
         for (auto &filename : m_xml_files) {
-
-            auto resolved_filename = resolveFileName(filename, detector_path_env);
-
-            LOG << "  - loading geometry file:  '" << resolved_filename << "' (patience ....)" << LOG_END;
-            try {
-                m_dd4hepGeo->fromCompact(resolved_filename);
-            } catch(std::runtime_error &e) {        // dd4hep throws std::runtime_error, no way to detail further
-                throw JException(e.what());
-            }
+            resolved_filenames.push_back(resolveFileName(filename, detector_path_env));
         }
-        m_dd4hepGeo->volumeManager();
-        m_dd4hepGeo->apply("DD4hepVolumeManager", 0, nullptr);
+        loadGeometry(resolved_filenames, use_snapshot ? snapshotFileName(resolved_filenames, snapshot_dir) : "");
         m_cellid_converter = std::make_shared<const dd4hep::rec::CellIDPositionConverter>(*m_dd4hepGeo);
 
         LOG << "Geometry successfully loaded." << LOG_END;
@@ -149,3 +200,56 @@ std::string JDD4hep_service::resolveFileName(const std::string &filename, char *
     }
     return result;
 }
+
+std::string JDD4hep_service::snapshotFileName(const std::vector<std::string> &xml_files, const std::string &snapshot_dir) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    std::set<std::string> visited;
+    for (auto &filename : xml_files) {
+        hashBytes(hash, filename);
+        hashXmlFile(hash, filename, visited);
+    }
+    return fmt::format("{}/dd4hep_geometry_{:016x}.root", snapshot_dir, hash);
+}
+
+void JDD4hep_service::loadGeometry(const std::vector<std::string> &xml_files, const std::string &snapshot_file) {
+
+    if (!snapshot_file.empty() && std::filesystem::exists(snapshot_file)) {
+        LOG << "  - loading geometry snapshot:  '" << snapshot_file << "'" << LOG_END;
+        if (dd4hep::DD4hepRootPersistency::load(*m_dd4hepGeo, snapshot_file.c_str(), "Geometry") != 1) {
+            throw JException("Cannot load geometry snapshot '%s'. Remove it to remake it from the XML files", snapshot_file.c_str());
+        }
+        if (!m_dd4hepGeo->volumeManager().isValid()) {
+            m_dd4hepGeo->apply("DD4hepVolumeManager", 0, nullptr);
+        }
+        m_loaded_from_snapshot = true;
+        return;
+    }
+
+    for (auto &filename : xml_files) {
+        LOG << "  - loading geometry file:  '" << filename << "' (patience ....)" << LOG_END;
+        try {
+            m_dd4hepGeo->fromCompact(filename);
+        } catch(std::runtime_error &e) {        // dd4hep throws std::runtime_error, no way to detail further
+            throw JException(e.what());
+        }
+    }
+    m_dd4hepGeo->volumeManager();
+    m_dd4hepGeo->apply("DD4hepVolumeManager", 0, nullptr);
+
+    if (snapshot_file.empty()) return;
+
+    // Write to a temporary file first, so that jobs starting at the same time never load
+    // a partially written snapshot. A failure only costs the speed-up of later jobs
+    auto tmp_file = fmt::format("{}.{}.tmp", snapshot_file, getpid());
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(snapshot_file).parent_path(), ec);
+    if (dd4hep::DD4hepRootPersistency::save(*m_dd4hepGeo, tmp_file.c_str(), "Geometry") == 1) {
+        std::filesystem::rename(tmp_file, snapshot_file, ec);
+        if (!ec) {
+            LOG << "  - saved geometry snapshot:  '" << snapshot_file << "'" << LOG_END;
+            return;
+        }
+    }
+    std::filesystem::remove(tmp_file, ec);
+    LOG_WARN(default_cout_logger) << "Could not save geometry snapshot '" << snapshot_file << "'" << LOG_END;
+}
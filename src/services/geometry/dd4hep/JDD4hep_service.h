@@ -44,6 +44,11 @@ public:
         return m_cellid_converter;
     }
 
+    /// True if the geometry was loaded from a dd4hep:snapshot. Such a geometry lacks the
+    /// extensions of detector elements (e.g. DDRec surfaces and parameters), so services
+    /// needing them must refuse it. Call after detector()
+    bool loadedFromSnapshot() const { return m_loaded_from_snapshot; }
+
 protected:
     void Initialize();
 
@@ -54,8 +59,16 @@ private:
     JApplication *app = nullptr;
     dd4hep::Detector* m_dd4hepGeo = nullptr;
     std::shared_ptr<const dd4hep::rec::CellIDPositionConverter> m_cellid_converter = nullptr;
+    bool m_loaded_from_snapshot = false;
     std::vector<std::string> m_xml_files;
 
     /// Ensures there is a geometry file that should be opened
     std::string resolveFileName(const std::string &filename, char *detector_path_env);
+
+    /// Name of the geometry snapshot file for the given XML files, keyed by the hash
+    /// of their content and of the XML files they include
+    std::string snapshotFileName(const std::vector<std::string> &xml_files, const std::string &snapshot_dir);
+
+    /// Reads the geometry from the XML files, or from the snapshot file if it exists
+    void loadGeometry(const std::vector<std::string> &xml_files, const std::string &snapshot_file);
 };
@@ -3,6 +3,9 @@
 
 #include "ActsGeo.h"
 
+#include <algorithm>
+#include <cmath>
+
 // constructor
 richgeo::ActsGeo::ActsGeo(std::string detName_, dd4hep::Detector *det_, std::shared_ptr<spdlog::logger> log_)
   : m_detName(detName_), m_det(det_), m_log(log_)
@@ -11,11 +14,29 @@ richgeo::ActsGeo::ActsGeo(std::string detName_, dd4hep::Detector *det_, std::sha
   std::transform(m_detName.begin(), m_detName.end(), m_detName.begin(), ::toupper);
 }
 
-// generate list ACTS disc surfaces, for a given radiator
+// list of ACTS disc surfaces, for a given radiator
 std::vector<std::shared_ptr<Acts::Surface>> richgeo::ActsGeo::TrackingPlanes(int radiator, int numPlanes) {
+  std::lock_guard<std::mutex> lock(m_tracking_planes_mutex);
+  auto key = std::make_pair(radiator, numPlanes);
+  auto it  = m_tracking_planes.find(key);
+  if(it == m_tracking_planes.end()) {
+    std::vector<std::shared_ptr<Acts::Surface>> discs;
+    std::vector<PlaneBounds> bounds;
+    BuildTrackingPlanes(radiator, numPlanes, discs, bounds);
+    m_tracking_plane_bounds.insert({ key, bounds });
+    it = m_tracking_planes.insert({ key, discs }).first;
+  }
+  return it->second;
+}
 
-  // output list of surfaces
-  std::vector<std::shared_ptr<Acts::Surface>> discs;
+// generate list ACTS disc surfaces, for a given radiator
+void richgeo::ActsGeo::BuildTrackingPlanes(
+    int radiator,
+    int numPlanes,
+    std::vector<std::shared_ptr<Acts::Surface>>& discs,
+    std::vector<PlaneBounds>& bounds
+    )
+{
 
   // dRICH DD4hep-ACTS bindings --------------------------------------------------------------------
   if(m_detName=="DRICH") {
@@ -61,7 +82,7 @@ std::vector<std::shared_ptr<Acts::Surface>> richgeo::ActsGeo::TrackingPlanes(int
         break;
       default:
         m_log->error("unknown radiator number {}",numPlanes);
-        return discs;
+        return;
     }
     trackRmin = [&] (auto z) { return rmin0 + boreSlope * (z - zmin); };
 
@@ -92,13 +113,38 @@ std::vector<std::shared_ptr<Acts::Surface>> richgeo::ActsGeo::TrackingPlanes(int
     m_log->debug("Define ACTS disks for {} radiator: {} disks in z=[ {}, {} ]",
         RadiatorName(radiator), numPlanes, trackZmin, trackZmax);
     double trackZstep = std::abs(trackZmax-trackZmin) / (numPlanes+1);
+
+    // a disc is entirely beyond the mirrors if its closest point to each mirror center is outside that mirror's sphere;
+    // any track point on it would fail `TrackPointCut`, so it is not needed
+    std::vector<dd4hep::Position> mirror_centers;
+    double mirror_radius = 0;
+    if(radiator == kGas) {
+      mirror_centers = MirrorCenters();
+      mirror_radius  = MirrorRadius();
+    }
+    auto beyond_mirrors = [&mirror_centers, &mirror_radius] (double z, double rmin, double rmax) {
+      if(mirror_centers.empty()) return false;
+      for(auto& c : mirror_centers) {
+        auto rho  = std::hypot(c.x(), c.y());
+        auto drho = std::max({ rmin - rho, rho - rmax, 0.0 });
+        if(std::hypot(drho, z - c.z()) < mirror_radius)
+          return false;
+      }
+      return true;
+    };
+
     for(int i=0; i<numPlanes; i++) {
       auto z         = trackZmin + (i+1)*trackZstep;
       auto rmin      = trackRmin(z);
       auto rmax      = trackRmax(z);
+      if(beyond_mirrors(z, rmin, rmax)) {
+        m_log->debug("  disk {}: z={} is beyond the mirrors; omitted", i, z);
+        continue;
+      }
       auto rbounds   = std::make_shared<Acts::RadialBounds>(rmin, rmax);
       auto transform = Acts::Transform3(Acts::Translation3(Acts::Vector3(0, 0, z)));
       discs.push_back(Acts::Surface::makeShared<Acts::DiscSurface>(transform, rbounds));
+      bounds.push_back({ z, rmin, rmax });
       m_log->debug("  disk {}: z={} r=[ {}, {} ]", i, z, rmin, rmax);
     }
   }
@@ -110,7 +156,6 @@ std::vector<std::shared_ptr<Acts::Surface>> richgeo::ActsGeo::TrackingPlanes(int
 
   // ------------------------------------------------------------------------------------------------
   else m_log->error("ActsGeo is not defined for detector '{}'",m_detName);
-  return discs;
 }
 
 // generate a cut to remove any track points that should not be used
@@ -122,14 +167,8 @@ std::function<bool(edm4eic::TrackPoint)> richgeo::ActsGeo::TrackPointCut(int rad
   if(m_detName=="DRICH" && radiator==kGas) {
 
     // get sphere centers
-    std::vector<dd4hep::Position> mirror_centers;
-    for(int isec = 0; isec < m_det->constant<int>("DRICH_num_sectors"); isec++)
-      mirror_centers.emplace_back(
-          m_det->constant<double>("DRICH_mirror_center_x_sec" + std::to_string(isec)) / dd4hep::mm,
-          m_det->constant<double>("DRICH_mirror_center_y_sec" + std::to_string(isec)) / dd4hep::mm,
-          m_det->constant<double>("DRICH_mirror_center_z_sec" + std::to_string(isec)) / dd4hep::mm
-          );
-    auto mirror_radius = m_det->constant<double>("DRICH_mirror_radius") / dd4hep::mm;
+    auto mirror_centers = MirrorCenters();
+    auto mirror_radius  = MirrorRadius();
 
     // beyond the mirror cut
     return [mirror_centers, mirror_radius] (edm4eic::TrackPoint p) {
@@ -150,3 +189,49 @@ std::function<bool(edm4eic::TrackPoint)> richgeo::ActsGeo::TrackPointCut(int rad
   return [] (edm4eic::TrackPoint p) { return true; };
 
 }
+
+// generate a cut on a trajectory's (eta,phi)
+std::function<bool(double,double)> richgeo::ActsGeo::TrackAcceptance(int radiator, int numPlanes, double margin) {
+
+  // theta range of straight lines from the origin which cross at least one plane
+  TrackingPlanes(radiator, numPlanes); // make sure the planes are built
+  std::vector<PlaneBounds> bounds;
+  {
+    std::lock_guard<std::mutex> lock(m_tracking_planes_mutex);
+    bounds = m_tracking_plane_bounds.at({ radiator, numPlanes });
+  }
+  if(bounds.empty()) {
+    m_log->warn("no tracking planes for radiator {}; not applying acceptance cut", RadiatorName(radiator));
+    return [] (double eta, double phi) { return true; };
+  }
+  double theta_min = M_PI;
+  double theta_max = 0.0;
+  for(const auto& plane : bounds) {
+    theta_min = std::min({ theta_min, std::atan2(plane.rmin, plane.z), std::atan2(plane.rmax, plane.z) });
+    theta_max = std::max({ theta_max, std::atan2(plane.rmin, plane.z), std::atan2(plane.rmax, plane.z) });
+  }
+  auto eta_of = [] (double theta) { return -std::log(std::tan(theta/2)); };
+  double eta_min = eta_of(theta_max) - margin;
+  double eta_max = eta_of(theta_min) + margin;
+  m_log->debug("{} radiator acceptance: eta=[ {}, {} ]", RadiatorName(radiator), eta_min, eta_max);
+
+  // the RICH sectors cover the full azimuth, so `phi` is not restricted
+  return [eta_min, eta_max] (double eta, double phi) { return eta >= eta_min && eta <= eta_max; };
+}
+
+// dRICH mirror sphere centers
+std::vector<dd4hep::Position> richgeo::ActsGeo::MirrorCenters() {
+  std::vector<dd4hep::Position> mirror_centers;
+  for(int isec = 0; isec < m_det->constant<int>("DRICH_num_sectors"); isec++)
+    mirror_centers.emplace_back(
+        m_det->constant<double>("DRICH_mirror_center_x_sec" + std::to_string(isec)) / dd4hep::mm,
+        m_det->constant<double>("DRICH_mirror_center_y_sec" + std::to_string(isec)) / dd4hep::mm,
+        m_det->constant<double>("DRICH_mirror_center_z_sec" + std::to_string(isec)) / dd4hep::mm
+        );
+  return mirror_centers;
+}
+
+// dRICH mirror sphere radius
+double richgeo::ActsGeo::MirrorRadius() {
+  return m_det->constant<double>("DRICH_mirror_radius") / dd4hep::mm;
+}
@@ -6,6 +6,10 @@
 
 #include <string>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
 #include <spdlog/spdlog.h>
 
 // DD4Hep
@@ -31,12 +35,19 @@ namespace richgeo {
       ActsGeo(std::string detName_, dd4hep::Detector *det_, std::shared_ptr<spdlog::logger> log_);
       ~ActsGeo() {}
 
-      // generate list ACTS disc surfaces, for a given radiator
+      // list of ACTS disc surfaces, for a given radiator
+      // - generated once for each `radiator` and `numPlanes`, then shared by all callers (thread safe)
+      // - planes which are entirely beyond the mirrors, and would always fail `TrackPointCut`, are omitted
       std::vector<std::shared_ptr<Acts::Surface>> TrackingPlanes(int radiator, int numPlanes);
 
       // generate a cut to remove any track points that should not be used
       std::function<bool(edm4eic::TrackPoint)> TrackPointCut(int radiator);
 
+      // generate a cut on a trajectory's (eta,phi), which rejects trajectories that cannot cross the
+      // `TrackingPlanes(radiator, numPlanes)`, assuming a straight line from the origin; the eta range
+      // is extended by `margin` on each side, to allow for bending and displaced vertices
+      std::function<bool(double,double)> TrackAcceptance(int radiator, int numPlanes, double margin);
+
     protected:
 
       std::string                     m_detName;
@@ -45,5 +56,27 @@ namespace richgeo {
 
     private:
 
+      // z position and radial bounds of a tracking plane
+      struct PlaneBounds {
+        double z, rmin, rmax;
+      };
+
+      // generate the tracking planes, and their bounds
+      void BuildTrackingPlanes(
+          int radiator,
+          int numPlanes,
+          std::vector<std::shared_ptr<Acts::Surface>>& discs,
+          std::vector<PlaneBounds>& bounds
+          );
+
+      // dRICH mirror sphere centers (one per sector) and radius [mm]
+      std::vector<dd4hep::Position> MirrorCenters();
+      double MirrorRadius();
+
+      // tracking planes cache: (radiator, numPlanes) -> planes
+      std::mutex m_tracking_planes_mutex;
+      std::map<std::pair<int,int>, std::vector<std::shared_ptr<Acts::Surface>>> m_tracking_planes;
+      std::map<std::pair<int,int>, std::vector<PlaneBounds>>                     m_tracking_plane_bounds;
+
   };
 }
@@ -70,6 +70,27 @@ void richgeo::IrtGeo::SetReadoutIDToPositionLambda() {
 }
 // ------------------------------------------------
 
+// tabulate the `cell ID -> pixel position` converter; cell IDs which are not in the table
+// fall back to the converter defined by `SetReadoutIDToPositionLambda`
+void richgeo::IrtGeo::SetReadoutIDToPositionTable(std::shared_ptr<ReadoutGeo> readoutGeo) {
+  if(readoutGeo==nullptr || !readoutGeo->HasPixelTable()) {
+    m_log->debug("no pixel table available; pixel positions will be computed for each hit");
+    return;
+  }
+  auto convert   = m_irtDetector->m_ReadoutIDToPosition;
+  auto positions = std::make_shared<std::vector<TVector3>>(readoutGeo->GetNumPixels());
+  readoutGeo->VisitAllReadoutPixels([&] (CellIDType cell_id) {
+    auto index = readoutGeo->GetPixelIndex(cell_id);
+    if(index >= 0) (*positions)[index] = convert(cell_id);
+  });
+  m_irtDetector->m_ReadoutIDToPosition = [readoutGeo, positions, convert] (auto cell_id) {
+    auto index = readoutGeo->GetPixelIndex(cell_id);
+    return index >= 0 ? (*positions)[index] : convert(cell_id);
+  };
+  m_log->debug("tabulated pixel positions for {} pixels", positions->size());
+}
+// ------------------------------------------------
+
 // fill table of refractive indices
 void richgeo::IrtGeo::SetRefractiveIndexTable() {
   m_log->debug("{:-^60}"," Refractive Index Tables ");
@@ -21,6 +21,7 @@
 
 // local
 #include "RichGeo.h"
+#include "ReadoutGeo.h"
 
 namespace richgeo {
   class IrtGeo {
@@ -35,6 +36,9 @@ namespace richgeo {
       // access the full IRT geometry
       CherenkovDetectorCollection *GetIrtDetectorCollection() { return m_irtDetectorCollection; }
 
+      // tabulate the `cell ID -> pixel position` converter for all pixels of `readoutGeo`'s pixel table
+      void SetReadoutIDToPositionTable(std::shared_ptr<ReadoutGeo> readoutGeo);
+
     protected:
 
       // protected methods
@@ -81,6 +81,16 @@ richgeo::ReadoutGeo::ReadoutGeo(std::string detName_, dd4hep::Detector *det_, st
 	lambda(cellID);
       }
     };
+
+    // decoding of the fields which identify a pixel
+    m_systemField = &(*m_readoutCoder)["system"];
+    m_sectorField = &(*m_readoutCoder)["sector"];
+    m_moduleField = &(*m_readoutCoder)["module"];
+    m_xField      = &(*m_readoutCoder)["x"];
+    m_yField      = &(*m_readoutCoder)["y"];
+
+    // precompute the geometry of all pixels
+    BuildPixelTable();
   }
 
   // pfRICH readout --------------------------------------------------------------------
@@ -92,3 +102,74 @@ richgeo::ReadoutGeo::ReadoutGeo(std::string detName_, dd4hep::Detector *det_, st
   else m_log->error("ReadoutGeo is not defined for detector '{}'",m_detName);
 
 }
+
+
+// dense pixel index
+long richgeo::ReadoutGeo::GetPixelIndex(CellIDType cellID) const {
+  if(m_pixels.empty() || m_systemField->value(cellID) != m_systemID)
+    return -1;
+  auto isec = m_sectorField->value(cellID);
+  auto imod = m_moduleField->value(cellID);
+  auto x    = m_xField->value(cellID);
+  auto y    = m_yField->value(cellID);
+  if(isec < 0 || isec >= m_num_sec || imod < 0 || imod >= m_num_mod || x < 0 || x >= m_num_px || y < 0 || y >= m_num_px)
+    return -1;
+  long index = ((isec * m_num_mod + imod) * m_num_px + x) * m_num_px + y;
+  return m_pixels[index].sensor == nullptr ? -1 : index;
+}
+
+// build the pixel table
+void richgeo::ReadoutGeo::BuildPixelTable() {
+  dd4hep::rec::CellIDPositionConverter cellid_converter(*m_det);
+  m_sensor_frames.assign(m_num_sec * m_num_mod, SensorFrame{});
+  std::vector<Pixel> pixels(m_num_sec * m_num_mod * m_num_px * m_num_px);
+  std::vector<bool>  have_sensor_frame(m_sensor_frames.size(), false);
+  std::size_t num_pixels = 0;
+
+  VisitAllReadoutPixels([&] (CellIDType cellID) {
+    auto isec = m_sectorField->value(cellID);
+    auto imod = m_moduleField->value(cellID);
+    auto x    = m_xField->value(cellID);
+    auto y    = m_yField->value(cellID);
+    if(isec < 0 || isec >= m_num_sec || imod < 0 || imod >= m_num_mod || x < 0 || x >= m_num_px || y < 0 || y >= m_num_px) {
+      m_log->warn("pixel cellID={:#018X} out of range for the pixel table", cellID);
+      return;
+    }
+    auto isensor = isec * m_num_mod + imod;
+    auto& frame  = m_sensor_frames[isensor];
+
+    // sensor frame, computed for the first pixel of each sensor
+    // (cf. `PhotoMultiplierHitDigi::get_sensor_local_position`)
+    if(!have_sensor_frame[isensor]) {
+      auto context     = cellid_converter.findContext(cellID);
+      auto sensor_elem = context->element;
+      double xyz_l[3], xyz_e[3], xyz_g[3];
+      sensor_elem.placement().position().GetCoordinates(xyz_l);
+      const auto& volToElement = context->toElement();
+      volToElement.LocalToMaster(xyz_l, xyz_e);
+      sensor_elem.nominal().worldTransformation().LocalToMaster(xyz_e, xyz_g);
+      frame.origin.SetCoordinates(xyz_g);
+      const double* rotation = volToElement.GetRotationMatrix();
+      std::copy(rotation, rotation + 9, frame.rotation.begin());
+      double norm_l[3] = {0.0, 0.0, 1.0}, norm_g[3];
+      volToElement.LocalToMasterVect(norm_l, norm_g);
+      frame.normal.SetCoordinates(norm_g);
+      have_sensor_frame[isensor] = true;
+    }
+
+    auto& pixel           = pixels[((isec * m_num_mod + imod) * m_num_px + x) * m_num_px + y];
+    pixel.cellID          = cellID;
+    pixel.global_position = cellid_converter.position(cellID);
+    pixel.local_position  = frame.ToLocal(pixel.global_position);
+    pixel.sensor          = &frame;
+    num_pixels++;
+  });
+
+  m_pixels = std::move(pixels);
+  m_readout_pixels.clear();
+  m_readout_pixels.reserve(num_pixels);
+  for(std::size_t index = 0; index < m_pixels.size(); index++)
+    if(m_pixels[index].sensor != nullptr)
+      m_readout_pixels.push_back(index);
+  m_log->debug("{} pixel table: {} pixels", m_detName, num_pixels);
+}
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <array>
 #include <string>
+#include <vector>
 #include <fmt/format.h>
 #include <functional>
 #include <spdlog/spdlog.h>
@@ -29,6 +31,31 @@ namespace richgeo {
       ReadoutGeo(std::string detName_, dd4hep::Detector *det_, std::shared_ptr<spdlog::logger> log_);
       ~ReadoutGeo() {}
 
+      // precomputed sensor frame
+      struct SensorFrame {
+        dd4hep::Position      origin;   // sensor position, global frame
+        std::array<double, 9> rotation; // local -> global rotation matrix (row-major)
+        dd4hep::Direction     normal;   // sensor surface normal (local z-axis), global frame
+
+        // transform global position `pos` to the sensor frame
+        dd4hep::Position ToLocal(const dd4hep::Position& pos) const {
+          auto d = pos - origin;
+          return dd4hep::Position(
+              rotation[0]*d.x() + rotation[3]*d.y() + rotation[6]*d.z(),
+              rotation[1]*d.x() + rotation[4]*d.y() + rotation[7]*d.z(),
+              rotation[2]*d.x() + rotation[5]*d.y() + rotation[8]*d.z()
+              );
+        }
+      };
+
+      // precomputed pixel geometry
+      struct Pixel {
+        CellIDType         cellID = 0;
+        dd4hep::Position   global_position;  // pixel volume centroid, global frame
+        dd4hep::Position   local_position;   // pixel volume centroid, sensor frame
+        const SensorFrame* sensor = nullptr; // nullptr if this pixel does not exist
+      };
+
       // define cellID encoding
       CellIDType cellIDEncoding(int isec, int imod, int x, int y)
       {
@@ -53,6 +80,21 @@ namespace richgeo {
 // set RNG seed
 void SetSeed(unsigned long seed) { m_random.SetSeed(seed); }
 
+      // pixel table, built once in the constructor by visiting all readout pixels
+      // - `GetPixelIndex` returns a dense index in [0, GetNumPixels()) for each pixel in the table, or -1
+      // - `GetPixel` returns the precomputed pixel geometry, or nullptr if `cellID` is not in the table
+      bool HasPixelTable() const { return !m_pixels.empty(); }
+      std::size_t GetNumPixels() const { return m_pixels.size(); }
+      long GetPixelIndex(CellIDType cellID) const;
+      const Pixel* GetPixel(CellIDType cellID) const {
+        auto index = GetPixelIndex(cellID);
+        return index < 0 ? nullptr : &m_pixels[index];
+      }
+      // - `GetReadoutPixel(i)`, for i in [0, GetNumReadoutPixels()), iterates over the pixels in the table,
+      //   without gaps; use it e.g. to draw random pixels
+      std::size_t GetNumReadoutPixels() const { return m_readout_pixels.size(); }
+      const Pixel& GetReadoutPixel(std::size_t i) const { return m_pixels[m_readout_pixels[i]]; }
+
     protected:
 
       // common objects
@@ -73,8 +115,21 @@ void SetSeed(unsigned long seed) { m_random.SetSeed(seed); }
 
     private:
 
+      // fill `m_sensor_frames` and `m_pixels`
+      void BuildPixelTable();
+
       // random number generators
       TRandomMixMax m_random;
 
+      // pixel table, indexed by `GetPixelIndex`
+      const dd4hep::DDSegmentation::BitFieldElement* m_systemField = nullptr;
+      const dd4hep::DDSegmentation::BitFieldElement* m_sectorField = nullptr;
+      const dd4hep::DDSegmentation::BitFieldElement* m_moduleField = nullptr;
+      const dd4hep::DDSegmentation::BitFieldElement* m_xField      = nullptr;
+      const dd4hep::DDSegmentation::BitFieldElement* m_yField      = nullptr;
+      std::vector<SensorFrame> m_sensor_frames; // indexed by `isec * m_num_mod + imod`
+      std::vector<Pixel>       m_pixels;
+      std::vector<std::size_t> m_readout_pixels; // indices of the `m_pixels` which exist
+
   };
 }
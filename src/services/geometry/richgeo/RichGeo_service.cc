@@ -14,9 +14,8 @@ void RichGeo_service::acquire_services(JServiceLocator *srv_locator) {
   m_log->set_level(eicrecon::ParseLogLevel(log_level_str));
   m_log->debug("RichGeo log level is set to {} ({})", log_level_str, m_log->level());
 
-  // DD4Hep geometry service
-  auto dd4hep_service = srv_locator->get<JDD4hep_service>();
-  m_dd4hepGeo = dd4hep_service->detector();
+  // DD4Hep geometry service; the geometry is loaded on first use
+  m_dd4hep_service = srv_locator->get<JDD4hep_service>();
 }
 
 // IrtGeo -----------------------------------------------------------
@@ -26,13 +25,16 @@ richgeo::IrtGeo *RichGeo_service::GetIrtGeo(std::string detector_name) {
   try {
     m_log->debug("Call RichGeo_service::GetIrtGeo initializer");
     auto initialize = [this,&detector_name] () {
-      if(!m_dd4hepGeo) throw JException("RichGeo_service m_dd4hepGeo==null which should never be!");
+      auto dd4hepGeo = GetDD4hepGeo();
+      if(!dd4hepGeo) throw JException("RichGeo_service DD4hep geometry is null, which should never be!");
       // instantiate IrtGeo-derived object, depending on detector
       auto which_rich = detector_name;
       std::transform(which_rich.begin(), which_rich.end(), which_rich.begin(), ::toupper);
-      if     ( which_rich=="DRICH"  ) m_irtGeo = new richgeo::IrtGeoDRICH(m_dd4hepGeo,  m_log);
-      else if( which_rich=="PFRICH" ) m_irtGeo = new richgeo::IrtGeoPFRICH(m_dd4hepGeo, m_log);
+      if     ( which_rich=="DRICH"  ) m_irtGeo = new richgeo::IrtGeoDRICH(dd4hepGeo,  m_log);
+      else if( which_rich=="PFRICH" ) m_irtGeo = new richgeo::IrtGeoPFRICH(dd4hepGeo, m_log);
       else throw JException(fmt::format("IrtGeo is not defined for detector '{}'",detector_name));
+      // use the precomputed pixel table for `cell ID -> pixel position` conversion
+      m_irtGeo->SetReadoutIDToPositionTable(GetReadoutGeo(detector_name));
     };
     std::call_once(m_init_irt, initialize);
   }
@@ -49,8 +51,9 @@ richgeo::ActsGeo *RichGeo_service::GetActsGeo(std::string detector_name) {
   try {
     m_log->debug("Call RichGeo_service::GetActsGeo initializer");
     auto initialize = [this,&detector_name] () {
-      if(!m_dd4hepGeo) throw JException("RichGeo_service m_dd4hepGeo==null which should never be!");
-      m_actsGeo = new richgeo::ActsGeo(detector_name, m_dd4hepGeo, m_log);
+      auto dd4hepGeo = GetDD4hepGeo();
+      if(!dd4hepGeo) throw JException("RichGeo_service DD4hep geometry is null, which should never be!");
+      m_actsGeo = new richgeo::ActsGeo(detector_name, dd4hepGeo, m_log);
     };
     std::call_once(m_init_acts, initialize);
   }
@@ -66,8 +69,9 @@ std::shared_ptr<richgeo::ReadoutGeo> RichGeo_service::GetReadoutGeo(std::string
   try {
     m_log->debug("Call RichGeo_service::GetReadoutGeo initializer");
     auto initialize = [this,&detector_name] () {
-      if(!m_dd4hepGeo) throw JException("RichGeo_service m_dd4hepGeo==null which should never be!");
-      m_readoutGeo = std::make_shared<richgeo::ReadoutGeo>(detector_name, m_dd4hepGeo, m_log);
+      auto dd4hepGeo = GetDD4hepGeo();
+      if(!dd4hepGeo) throw JException("RichGeo_service DD4hep geometry is null, which should never be!");
+      m_readoutGeo = std::make_shared<richgeo::ReadoutGeo>(detector_name, dd4hepGeo, m_log);
     };
     std::call_once(m_init_readout, initialize);
   }
@@ -80,8 +84,7 @@ std::shared_ptr<richgeo::ReadoutGeo> RichGeo_service::GetReadoutGeo(std::string
 // Destructor --------------------------------------------------------
 RichGeo_service::~RichGeo_service() {
   try {
-    if(m_dd4hepGeo) m_dd4hepGeo->destroyInstance();
-    m_dd4hepGeo = nullptr;
+    // the DD4hep geometry is destroyed by JDD4hep_service
     delete m_irtGeo;
     delete m_actsGeo;
   } catch (...) {}
@@ -29,8 +29,8 @@ class RichGeo_service : public JService {
     RichGeo_service(JApplication *app) : m_app(app) {}
     virtual ~RichGeo_service();
 
-    // return pointer to the main DD4hep Detector
-    virtual dd4hep::Detector *GetDD4hepGeo() { return m_dd4hepGeo; };
+    // return pointer to the main DD4hep Detector; loads the geometry upon the first time called
+    virtual dd4hep::Detector *GetDD4hepGeo() { return m_dd4hep_service->detector(); };
 
     // return pointers to geometry bindings; initializes the bindings upon the first time called
     virtual richgeo::IrtGeo *GetIrtGeo(std::string detector_name);
@@ -45,7 +45,7 @@ class RichGeo_service : public JService {
     std::once_flag   m_init_acts;
     std::once_flag   m_init_readout;
     JApplication        *m_app        = nullptr;
-    dd4hep::Detector    *m_dd4hepGeo  = nullptr;
+    std::shared_ptr<JDD4hep_service> m_dd4hep_service;
     richgeo::IrtGeo     *m_irtGeo     = nullptr;
     richgeo::ActsGeo    *m_actsGeo    = nullptr;
     std::shared_ptr<richgeo::ReadoutGeo> m_readoutGeo;
@@ -1,11 +1,23 @@
 
 #include "JEventProcessorPODIO.h"
 #include "services/log/Log_service.h"
+#include "services/trace/Trace_service.h"
 #include <JANA/Services/JComponentManager.h>
 #include <podio/Frame.h>
 
 #include "datamodel_glue.h"
+#include "extensions/jana/JChainScheduler.h"
 #include <algorithm>
+#include <filesystem>
+#include <fnmatch.h>
+
+#include <Compression.h>
+#include <TBranch.h>
+#include <TFile.h>
+#include <TROOT.h>
+#include <TTree.h>
+#include <TVirtualMutex.h>
+#include <fmt/format.h>
 
 
 JEventProcessorPODIO::JEventProcessorPODIO() {
@@ -34,6 +46,42 @@ JEventProcessorPODIO::JEventProcessorPODIO() {
             "Directory name to make an additional copy of the output file to. Copy will be done at end of processing. Default is empty string which means do not make a copy. No check is made on path existing."
     );
 
+    japp->SetDefaultParameter(
+            "podio:output_shards",
+            m_output_shards,
+            "Number of output files written in parallel. Events are distributed round-robin over the shards, which spreads serialization and compression over several threads. Shard files are named <stem>_shard<N>.root"
+    );
+
+    japp->SetDefaultParameter(
+            "podio:output_max_events_per_file",
+            m_output_max_events_per_file,
+            "Start a new output file after this many events have been written to it. Files are then named <stem>_<NNNN>.root. Default is 0 which means no limit."
+    );
+
+    japp->SetDefaultParameter(
+            "podio:output_max_bytes_per_file",
+            m_output_max_bytes_per_file,
+            "Start a new output file once the current one has grown past this many bytes (as seen on disk, so ROOT buffering makes this approximate). Default is 0 which means no limit."
+    );
+
+    japp->SetDefaultParameter(
+            "podio:output_compression",
+            m_output_compression,
+            "Compression of the output file as ALGORITHM:LEVEL with ALGORITHM one of ZLIB, LZMA, LZ4, ZSTD (e.g. ZSTD:5), or 0 for no compression. Default is empty string which means the ROOT default."
+    );
+
+    japp->SetDefaultParameter(
+            "podio:output_compression_rules",
+            m_output_compression_rules,
+            "Comma separated list of PATTERN=ALGORITHM:LEVEL overriding podio:output_compression for the collections whose names match the glob PATTERN, e.g. *RawHits=LZMA:9,Reconstructed*=LZ4:4. The first matching rule wins."
+    );
+
+    japp->SetDefaultParameter(
+            "podio:prefetch_tasks",
+            m_prefetch_tasks,
+            "Number of threads of a pool, shared by all events, running the factories of an event before it is written, following the dependencies between their input and output tags. The thread processing the event runs them too. Default is 0 which means the factories run one after the other, when requested. Factories must only request their declared inputs. Collections then enter the event frame in varying order, so this needs podio collection IDs derived from the collection names."
+    );
+
     // Get the list of output collections to include/exclude
     std::vector<std::string> output_include_collections={
             "MCParticles",
@@ -199,13 +247,176 @@ void JEventProcessorPODIO::Init() {
     auto app = GetApplication();
     m_log = app->GetService<Log_service>()->logger("JEventProcessorPODIO");
     m_log->set_level(spdlog::level::debug);
-    m_writer = std::make_unique<podio::ROOTFrameWriter>(m_output_file);
+
+    if (m_output_shards == 0) {
+        m_log->warn("podio:output_shards=0 is not valid, using 1");
+        m_output_shards = 1;
+    }
+
+    if (!m_output_compression.empty()) {
+        m_default_compression = ParseCompressionSettings(m_output_compression);
+    }
+    for (const auto& rule : m_output_compression_rules) {
+        auto pos = rule.find('=');
+        if (pos == std::string::npos || pos == 0) {
+            throw JException("podio:output_compression_rules: expected PATTERN=ALGORITHM:LEVEL, got '%s'", rule.c_str());
+        }
+        m_compression_rules.push_back({rule.substr(0, pos), ParseCompressionSettings(rule.substr(pos + 1))});
+    }
+
+    // Writers of different shards run concurrently on their own TFiles
+    if (m_output_shards > 1) ROOT::EnableThreadSafety();
+
+    for (size_t shard_index = 0; shard_index < m_output_shards; shard_index++) {
+        auto shard = std::make_unique<OutputShard>();
+        OpenShardFile(*shard, shard_index);
+        m_shards.push_back(std::move(shard));
+    }
     // TODO: NWB: Verify that output file is writable NOW, rather than after event processing completes.
     //       I definitely don't trust PODIO to do this for me.
 
 }
 
 
+std::string JEventProcessorPODIO::MakeOutputFileName(size_t shard_index, size_t file_index) const {
+
+    // Without sharding or rollover, the output file name is used as given
+    bool rollover = m_output_max_events_per_file > 0 || m_output_max_bytes_per_file > 0;
+    if (m_output_shards == 1 && !rollover) return m_output_file;
+
+    std::filesystem::path path(m_output_file);
+    std::string name = path.stem().string();
+    if (m_output_shards > 1) name += fmt::format("_shard{}", shard_index);
+    if (rollover) name += fmt::format("_{:04d}", file_index);
+    name += path.extension().string();
+    return path.replace_filename(name).string();
+}
+
+
+void JEventProcessorPODIO::OpenShardFile(OutputShard& shard, size_t shard_index) {
+
+    // Close the current file of this shard, if any, before opening the next one
+    if (shard.writer) {
+        shard.writer->finish();
+        m_log->info("Closed output file '{}' with {} events", shard.filename, shard.events_in_file);
+        shard.file_index++;
+    }
+    shard.filename = MakeOutputFileName(shard_index, shard.file_index);
+    shard.writer = std::make_unique<podio::ROOTFrameWriter>(shard.filename);
+    shard.events_in_file = 0;
+    shard.compression_applied = false;
+
+    // The writer does not expose its TFile, but ROOT keeps track of it. Branches take
+    // their compression from the file when they are created on the first writeFrame.
+    if (m_default_compression >= 0) {
+        auto* file = FindShardFile(shard);
+        if (file != nullptr) file->SetCompressionSettings(m_default_compression);
+    }
+    m_log->debug("Opened output file '{}'", shard.filename);
+}
+
+
+TFile* JEventProcessorPODIO::FindShardFile(const OutputShard& shard) const {
+
+    // The list of files is shared with every other thread opening or closing a TFile,
+    // e.g. the reader threads of the podio source
+    R__LOCKGUARD(gROOTMutex);
+    return dynamic_cast<TFile*>(gROOT->GetListOfFiles()->FindObject(shard.filename.c_str()));
+}
+
+
+int JEventProcessorPODIO::ParseCompressionSettings(const std::string& spec) {
+
+    if (spec == "0") return 0;
+
+    auto pos = spec.find(':');
+    std::string algorithm_name = spec.substr(0, pos);
+    int level = 1;
+    if (pos != std::string::npos) {
+        try {
+            level = std::stoi(spec.substr(pos + 1));
+        } catch (std::exception&) {
+            throw JException("Invalid compression level in '%s'", spec.c_str());
+        }
+    }
+    if (level < 0 || level > 9) {
+        throw JException("Compression level must be between 0 and 9 in '%s'", spec.c_str());
+    }
+
+    std::transform(algorithm_name.begin(), algorithm_name.end(), algorithm_name.begin(), ::toupper);
+    ROOT::RCompressionSetting::EAlgorithm::EValues algorithm;
+    if (algorithm_name == "ZLIB") algorithm = ROOT::RCompressionSetting::EAlgorithm::kZLIB;
+    else if (algorithm_name == "LZMA") algorithm = ROOT::RCompressionSetting::EAlgorithm::kLZMA;
+    else if (algorithm_name == "LZ4") algorithm = ROOT::RCompressionSetting::EAlgorithm::kLZ4;
+    else if (algorithm_name == "ZSTD") algorithm = ROOT::RCompressionSetting::EAlgorithm::kZSTD;
+    else throw JException("Unknown compression algorithm '%s' (expected ZLIB, LZMA, LZ4 or ZSTD)", algorithm_name.c_str());
+
+    return ROOT::CompressionSettings(algorithm, level);
+}
+
+
+int JEventProcessorPODIO::GetCollectionCompression(const std::string& collection_name) const {
+
+    for (const auto& rule : m_compression_rules) {
+        if (fnmatch(rule.pattern.c_str(), collection_name.c_str(), 0) == 0) return rule.settings;
+    }
+    return -1;
+}
+
+
+void JEventProcessorPODIO::ApplyCompressionPolicy(OutputShard& shard, const std::vector<std::string>& collections) {
+
+    // Called right after the first event has been written to the file, since the writer
+    // creates its branches in its first writeFrame. Baskets pick up the compression settings
+    // of their branch when they are written, so this applies to all baskets written from now
+    // on. A basket that the first event already filled, i.e. a collection of the first event
+    // larger than the basket size, has been written with the file settings.
+    shard.compression_applied = true;
+    if (m_compression_rules.empty()) return;
+
+    auto* file = FindShardFile(shard);
+    auto* tree = file != nullptr ? file->Get<TTree>("events") : nullptr;
+    if (tree == nullptr) {
+        m_log->warn("Cannot find events tree in '{}', compression rules not applied", shard.filename);
+        return;
+    }
+
+    // Besides the branch named after the collection itself, podio writes a branch per
+    // relation (<name>#<i>) and per vector member (<name>_<i>). Assign every branch to
+    // the longest collection name it starts with, so that e.g. "Foo_Bar" is not taken for
+    // a vector member branch of "Foo".
+    for (auto* object : *tree->GetListOfBranches()) {
+        auto* branch = static_cast<TBranch*>(object);
+        std::string branch_name = branch->GetName();
+        const std::string* owner = nullptr;
+        for (const auto& coll : collections) {
+            if (branch_name.compare(0, coll.size(), coll) != 0) continue;
+            bool is_collection_branch = branch_name.size() == coll.size()
+                || branch_name[coll.size()] == '#' || branch_name[coll.size()] == '_';
+            if (is_collection_branch && (owner == nullptr || coll.size() > owner->size())) owner = &coll;
+        }
+        if (owner == nullptr) continue;
+
+        int settings = GetCollectionCompression(*owner);
+        if (settings < 0) continue;
+        branch->SetCompressionSettings(settings);
+        m_log->debug("Compressing branch '{}' of '{}' with settings {}", branch_name, shard.filename, settings);
+    }
+}
+
+
+bool JEventProcessorPODIO::IsShardFileFull(const OutputShard& shard) const {
+
+    if (m_output_max_events_per_file > 0 && shard.events_in_file >= m_output_max_events_per_file) return true;
+    if (m_output_max_bytes_per_file > 0) {
+        std::error_code ec;
+        auto bytes = std::filesystem::file_size(shard.filename, ec);
+        if (!ec && bytes >= m_output_max_bytes_per_file) return true;
+    }
+    return false;
+}
+
+
 void JEventProcessorPODIO::FindCollectionsToWrite(const std::shared_ptr<const JEvent>& event) {
 
     // Set up the set of collections_to_write.
@@ -226,6 +437,7 @@ void JEventProcessorPODIO::FindCollectionsToWrite(const std::shared_ptr<const JE
 
         // We match up the include list with what is actually present in the event
         std::set<std::string> all_collections_set = std::set<std::string>(all_collections.begin(), all_collections.end());
+        std::vector<std::string> missing_collections;
 
         for (const auto& col : m_output_include_collections) {
             if (m_output_exclude_collections.find(col) == m_output_exclude_collections.end()) {
@@ -233,6 +445,7 @@ void JEventProcessorPODIO::FindCollectionsToWrite(const std::shared_ptr<const JE
                 if (all_collections_set.find(col) == all_collections_set.end()) {
                     // Included, but not a valid PODIO type
                     m_log->warn("Explicitly included collection '{}' not present in factory set, omitting.", col);
+                    missing_collections.push_back(col);
                 }
                 else {
                     // Included, not excluded, and a valid PODIO type
@@ -241,15 +454,43 @@ void JEventProcessorPODIO::FindCollectionsToWrite(const std::shared_ptr<const JE
                 }
             }
         }
+
+        // With lazy factories, the user asked for exactly these collections: do not quietly write fewer
+        if (!missing_collections.empty() && eicrecon::JChainGraph::Instance().IsLazy()) {
+            std::string names;
+            for (const auto& col : missing_collections) names += (names.empty() ? "" : ", ") + col;
+            throw JException(fmt::format("Included collections not made by any factory or by the source, with eicrecon:lazy_factories=1: {}", names));
+        }
     }
 
 }
 
 void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    static const auto trace_lock_wait  = Trace_service::NameId("JEventProcessorPODIO:lock_wait");
+    static const auto trace_collect    = Trace_service::NameId("JEventProcessorPODIO:collect");
+    static const auto trace_shard_wait = Trace_service::NameId("JEventProcessorPODIO:shard_lock_wait");
+    static const auto trace_write      = Trace_service::NameId("JEventProcessorPODIO:write");
+    static const auto trace_prefetch   = Trace_service::NameId("JEventProcessorPODIO:prefetch");
+
+    // Run independent factory chains concurrently, before serializing on the lock
+    if (m_prefetch_planned.load(std::memory_order_acquire)) {
+        Trace_service::Span prefetch_span(trace_prefetch, "factory", event->GetEventNumber());
+        m_prefetch_scheduler.Run(*event);
+    }
+
+    Trace_service::Span lock_wait_span(trace_lock_wait, "lock", event->GetEventNumber());
+    std::unique_lock<std::mutex> lock(m_mutex);
+    lock_wait_span.End();
+    Trace_service::Span collect_span(trace_collect, "output", event->GetEventNumber());
     if (m_is_first_event) {
         FindCollectionsToWrite(event);
+        if (m_prefetch_tasks > 0) {
+            m_prefetch_scheduler.Plan(m_collections_to_write, m_prefetch_tasks);
+            m_prefetch_planned.store(true, std::memory_order_release);
+            m_log->info("Prefetching {} factories with a pool of {} threads",
+                        m_prefetch_scheduler.GetNumPlannedFactories(), m_prefetch_tasks);
+        }
     }
 
     // Trigger all collections once to fix the collection IDs
@@ -332,6 +573,12 @@ void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
             }
         }
         catch(std::exception &e) {
+            // With lazy factories, a factory that requests a collection by a fixed name may
+            // miss its skipped producer; stop rather than write the events without it
+            if (m_is_first_event && eicrecon::JChainGraph::Instance().IsLazy()) {
+                throw JException(fmt::format("Collection '{}' failed in the first event, with eicrecon:lazy_factories=1: {}. "
+                                             "Add the collections its factory requests to eicrecon:lazy_extra_collections", coll, e.what()));
+            }
             // Limit printing warning to just once per factory
             if (failed_collections.count(coll) == 0) {
                 m_log->error("Omitting PODIO collection '{}' due to exception: {}.", coll, e.what());
@@ -354,11 +601,31 @@ void JEventProcessorPODIO::Process(const std::shared_ptr<const JEvent> &event) {
         m_log->info("Writing collection '{}' with id {}", collname, frame->get(collname)->getID());
     }
     */
-    m_writer->writeFrame(*frame, "events", m_collections_to_write);
     m_is_first_event = false;
 
+    // Pick the shard for this event and release the global lock, so that
+    // serialization and compression of different shards can overlap.
+    size_t shard_index = m_next_shard;
+    m_next_shard = (m_next_shard + 1) % m_shards.size();
+    std::vector<std::string> collections_to_write = m_collections_to_write;
+    lock.unlock();
+    collect_span.End();
+
+    auto& shard = *m_shards[shard_index];
+    Trace_service::Span shard_wait_span(trace_shard_wait, "lock", event->GetEventNumber());
+    std::lock_guard<std::mutex> shard_lock(shard.mutex);
+    shard_wait_span.End();
+    Trace_service::Span write_span(trace_write, "output", event->GetEventNumber());
+    if (IsShardFileFull(shard)) OpenShardFile(shard, shard_index);
+    shard.writer->writeFrame(*frame, "events", collections_to_write);
+    shard.events_in_file++;
+    if (!shard.compression_applied) ApplyCompressionPolicy(shard, collections_to_write);
+
 }
 
 void JEventProcessorPODIO::Finish() {
-    m_writer->finish();
+    for (auto& shard : m_shards) {
+        std::lock_guard<std::mutex> shard_lock(shard->mutex);
+        shard->writer->finish();
+    }
 }
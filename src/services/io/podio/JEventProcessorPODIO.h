@@ -5,6 +5,12 @@
 #include <spdlog/spdlog.h>
 #include <podio/ROOTFrameWriter.h>
 
+#include <atomic>
+
+#include "extensions/jana/JChainScheduler.h"
+
+class TFile;
+
 
 class JEventProcessorPODIO : public JEventProcessor {
 
@@ -19,7 +25,35 @@ public:
 
     void FindCollectionsToWrite(const std::shared_ptr<const JEvent>& event);
 
-    std::unique_ptr<podio::ROOTFrameWriter> m_writer;
+    /// One output stream. Each shard has its own writer and lock, so shards can
+    /// serialize and compress events concurrently.
+    struct OutputShard {
+        std::mutex mutex;
+        std::unique_ptr<podio::ROOTFrameWriter> writer;
+        std::string filename;
+        size_t file_index = 0;
+        size_t events_in_file = 0;
+        bool compression_applied = false;
+    };
+
+    /// Compression settings for all collections whose name matches a glob pattern,
+    /// e.g. "*RawHits" -> LZMA level 9. Settings use ROOT's 100*algorithm+level encoding.
+    struct CompressionRule {
+        std::string pattern;
+        int settings;
+    };
+
+    static int ParseCompressionSettings(const std::string& spec);
+    int GetCollectionCompression(const std::string& collection_name) const;
+    void ApplyCompressionPolicy(OutputShard& shard, const std::vector<std::string>& collections);
+
+    std::string MakeOutputFileName(size_t shard_index, size_t file_index) const;
+    void OpenShardFile(OutputShard& shard, size_t shard_index);
+    TFile* FindShardFile(const OutputShard& shard) const;
+    bool IsShardFileFull(const OutputShard& shard) const;
+
+    std::vector<std::unique_ptr<OutputShard>> m_shards;
+    size_t m_next_shard = 0;
     std::mutex m_mutex;
     bool m_is_first_event = true;
     bool m_user_included_collections = false;
@@ -27,9 +61,20 @@ public:
 
     std::string m_output_file = "podio_output.root";
     std::string m_output_file_copy_dir = "";
+    size_t m_output_shards = 1;                 // config. parameter
+    size_t m_output_max_events_per_file = 0;    // config. parameter (0 = no limit)
+    size_t m_output_max_bytes_per_file = 0;     // config. parameter (0 = no limit)
+    std::string m_output_compression;           // config. parameter (empty = ROOT default)
+    std::vector<std::string> m_output_compression_rules;  // config. parameter
+    int m_default_compression = -1;             // derived from above config. parameters (-1 = not set)
+    std::vector<CompressionRule> m_compression_rules;     // derived from above config. parameters
     std::set<std::string> m_output_include_collections;  // config. parameter
     std::set<std::string> m_output_exclude_collections;  // config. parameter
     std::vector<std::string> m_collections_to_write;  // derived from above config. parameters
     std::vector<std::string> m_collections_to_print;
 
+    size_t m_prefetch_tasks = 0;                // config. parameter (0 = off)
+    eicrecon::JChainScheduler m_prefetch_scheduler;  // planned in the first event
+    std::atomic<bool> m_prefetch_planned{false};
+
 };
@@ -5,21 +5,32 @@
 // This is a JANA event source that uses PODIO to read from a ROOT
 // file created using the EDM4hep Data Model.
 //
-// This uses the podio supplied RootReader and EventStore classes. Thus,
-// it is limited to processing only a single event at a time.
+// Frames are read with podio's ROOTFrameReader. A single input file is read
+// in GetEvent; when the input is several files (a glob pattern or a .list
+// file), podio:num_readers reader threads read them concurrently into a
+// bounded queue of frames that GetEvent drains.
 
 #include "JEventSourcePODIO.h"
 
 #include <JANA/JApplication.h>
 #include <JANA/JEvent.h>
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <glob.h>
+#include <optional>
+#include <sstream>
 #include <fmt/color.h>
 
 #include <JANA/JFactoryGenerator.h>
 
 // podio specific includes
+#include <podio/GenericParameters.h>
 #include <podio/podioVersion.h>
 #include <TFile.h>
+#include <TROOT.h>
+#include <TTree.h>
 
 #include <fmt/format.h>
 
@@ -27,6 +38,9 @@
 #include "datamodel_includes.h"
 #include "datamodel_glue.h"
 
+#include "extensions/jana/JEventAdmission.h"
+#include "services/trace/Trace_service.h"
+
 
 //------------------------------------------------------------------------------
 // InsertingVisitor
@@ -54,6 +68,203 @@ struct InsertingVisitor {
 };
 
 
+//------------------------------------------------------------------------------
+// SplitFrameData
+//
+/// podio frame data that exposes only part of the collections of an entry. With
+/// background merging, an entry is split into two frames: the event frame, without
+/// the collections to be merged, and the signal frame with only those. The merged
+/// collections are then put into the event frame under the original names, which a
+/// frame does not allow for collections it has read. Both frames share the entry's
+/// data; the parameters go to the event frame.
+//------------------------------------------------------------------------------
+class SplitFrameData {
+public:
+    SplitFrameData(std::shared_ptr<podio::ROOTFrameData> data, std::shared_ptr<const std::set<std::string>> names, bool is_event_frame) :
+            m_data(std::move(data)), m_names(std::move(names)), m_is_event_frame(is_event_frame) {};
+
+    podio::CollectionIDTable getIDTable() const { return m_data->getIDTable(); }
+
+    std::optional<podio::CollectionReadBuffers> getCollectionBuffers(const std::string& name) {
+        if (!IsVisible(name)) return std::nullopt;
+        return m_data->getCollectionBuffers(name);
+    }
+
+    std::vector<std::string> getAvailableCollections() const {
+        std::vector<std::string> collections;
+        for (const auto& name : m_data->getAvailableCollections()) {
+            if (IsVisible(name)) collections.push_back(name);
+        }
+        return collections;
+    }
+
+    std::unique_ptr<podio::GenericParameters> getParameters() {
+        if (!m_is_event_frame) return std::make_unique<podio::GenericParameters>();
+        return m_data->getParameters();
+    }
+
+private:
+    bool IsVisible(const std::string& name) const { return (m_names->count(name) == 0) == m_is_event_frame; }
+
+    std::shared_ptr<podio::ROOTFrameData> m_data;
+    std::shared_ptr<const std::set<std::string>> m_names;   // collections of the signal frame
+    bool m_is_event_frame;
+};
+
+
+//------------------------------------------------------------------------------
+// BackgroundMerger
+//
+/// Builds new MCParticle and simulated hit collections from the signal frame and
+/// the background frames. Background hits are appended to the signal collection of
+/// the same name, shifted in time by a fixed offset per background frame. Background
+/// MCParticles are appended to the signal MCParticles, so that the MCParticle
+/// references of all merged objects, and the parent/daughter references of the
+/// particles, point into the merged MCParticles collection that is written out.
+/// Background particles and tracker hits are marked with their overlay bit.
+/// The signal is copied as well: a collection read from file is written from its
+/// read buffers, so background objects appended to it would not be written.
+/// BackgroundMerger is used in MergeBackground()
+//------------------------------------------------------------------------------
+class BackgroundMerger {
+public:
+
+    /// Add the MCParticles and simulated hits of `source`. Hit collections of
+    /// background frames that are not in the signal frame are ignored
+    void Add(const podio::Frame& source, double time_offset, bool is_background) {
+
+        const auto* particles = dynamic_cast<const edm4hep::MCParticleCollection*>(source.get("MCParticles"));
+        std::size_t first = m_particles.size();
+
+        // The merged copy of a particle of `source`, if it is one
+        auto merged_particle = [&] (const edm4hep::MCParticle& particle) -> std::optional<edm4hep::MCParticle> {
+            if (particles == nullptr || !particle.isAvailable()) return std::nullopt;
+            auto id = particle.getObjectID();
+            if (id.collectionID != particles->getID() || id.index < 0 || static_cast<std::size_t>(id.index) >= particles->size()) return std::nullopt;
+            return m_particles[first + id.index];
+        };
+
+        if (particles != nullptr) {
+            for (const auto& source_particle : *particles) {
+                auto particle = m_particles.create();
+                particle.setPDG(source_particle.getPDG());
+                particle.setGeneratorStatus(source_particle.getGeneratorStatus());
+                particle.setSimulatorStatus(source_particle.getSimulatorStatus());
+                particle.setCharge(source_particle.getCharge());
+                particle.setTime(source_particle.getTime() + time_offset);
+                particle.setMass(source_particle.getMass());
+                particle.setVertex(source_particle.getVertex());
+                particle.setEndpoint(source_particle.getEndpoint());
+                particle.setMomentum(source_particle.getMomentum());
+                particle.setMomentumAtEndpoint(source_particle.getMomentumAtEndpoint());
+                particle.setSpin(source_particle.getSpin());
+                particle.setColorFlow(source_particle.getColorFlow());
+                if (is_background) particle.setOverlay(true);
+            }
+            for (std::size_t i = 0; i < particles->size(); i++) {
+                auto particle = m_particles[first + i];
+                for (const auto& parent : (*particles)[i].getParents()) {
+                    if (auto merged = merged_particle(parent)) particle.addToParents(*merged);
+                }
+                for (const auto& daughter : (*particles)[i].getDaughters()) {
+                    if (auto merged = merged_particle(daughter)) particle.addToDaughters(*merged);
+                }
+            }
+        }
+
+        for (const std::string& coll_name : source.getAvailableCollections()) {
+            const podio::CollectionBase* collection = source.get(coll_name);
+
+            if (const auto* source_hits = dynamic_cast<const edm4hep::SimTrackerHitCollection*>(collection)) {
+                auto it = m_tracker_hits.find(coll_name);
+                if (it == m_tracker_hits.end()) {
+                    if (is_background) continue;
+                    it = m_tracker_hits.emplace(coll_name, edm4hep::SimTrackerHitCollection()).first;
+                }
+                for (const auto& source_hit : *source_hits) {
+                    auto hit = it->second.create();
+                    hit.setCellID(source_hit.getCellID());
+                    hit.setEDep(source_hit.getEDep());
+                    hit.setTime(source_hit.getTime() + time_offset);
+                    hit.setPathLength(source_hit.getPathLength());
+                    hit.setQuality(source_hit.getQuality());
+                    hit.setPosition(source_hit.getPosition());
+                    hit.setMomentum(source_hit.getMomentum());
+                    if (is_background) hit.setOverlay(true);
+                    if (auto merged = merged_particle(source_hit.getMCParticle())) hit.setMCParticle(*merged);
+                }
+            }
+
+            else if (const auto* source_hits = dynamic_cast<const edm4hep::SimCalorimeterHitCollection*>(collection)) {
+                // The hit times of calorimeter hits live in their contributions
+                auto it = m_calorimeter_hits.find(coll_name);
+                if (it == m_calorimeter_hits.end()) {
+                    if (is_background) continue;
+                    it = m_calorimeter_hits.emplace(coll_name, CalorimeterHits()).first;
+                }
+                auto& [hits, contribs] = it->second;
+                for (const auto& source_hit : *source_hits) {
+                    auto hit = hits.create();
+                    hit.setCellID(source_hit.getCellID());
+                    hit.setEnergy(source_hit.getEnergy());
+                    hit.setPosition(source_hit.getPosition());
+                    for (const auto& source_contrib : source_hit.getContributions()) {
+                        auto contrib = contribs.create();
+                        contrib.setPDG(source_contrib.getPDG());
+                        contrib.setEnergy(source_contrib.getEnergy());
+                        contrib.setTime(source_contrib.getTime() + time_offset);
+                        contrib.setStepPosition(source_contrib.getStepPosition());
+                        if (auto merged = merged_particle(source_contrib.getParticle())) contrib.setParticle(*merged);
+                        hit.addToContributions(contrib);
+                    }
+                }
+            }
+        }
+    }
+
+    /// Put the merged collections into `frame`, under the names of the signal collections.
+    /// The contributions of calorimeter hits "X" are put as "XContributions"
+    void Put(podio::Frame& frame) {
+        frame.put(std::move(m_particles), "MCParticles");
+        for (auto& [coll_name, hits] : m_tracker_hits) {
+            frame.put(std::move(hits), coll_name);
+        }
+        for (auto& [coll_name, calorimeter_hits] : m_calorimeter_hits) {
+            frame.put(std::move(calorimeter_hits.first), coll_name);
+            frame.put(std::move(calorimeter_hits.second), coll_name + "Contributions");
+        }
+    }
+
+private:
+    using CalorimeterHits = std::pair<edm4hep::SimCalorimeterHitCollection, edm4hep::CaloHitContributionCollection>;
+
+    edm4hep::MCParticleCollection m_particles;
+    std::map<std::string, edm4hep::SimTrackerHitCollection> m_tracker_hits;
+    std::map<std::string, CalorimeterHits> m_calorimeter_hits;
+};
+
+
+//------------------------------------------------------------------------------
+// CountSimHits
+//
+/// Number of simulated tracker and calorimeter hits, and calorimeter hit contributions,
+/// in the frame. Used as the cost of the event for admission control, since the memory
+/// of an event in reconstruction mostly scales with it.
+//------------------------------------------------------------------------------
+static std::size_t CountSimHits(const podio::Frame& frame) {
+    std::size_t num_hits = 0;
+    for (const std::string& coll_name : frame.getAvailableCollections()) {
+        const podio::CollectionBase* collection = frame.get(coll_name);
+        if (dynamic_cast<const edm4hep::SimTrackerHitCollection*>(collection) != nullptr ||
+            dynamic_cast<const edm4hep::SimCalorimeterHitCollection*>(collection) != nullptr ||
+            dynamic_cast<const edm4hep::CaloHitContributionCollection*>(collection) != nullptr) {
+            num_hits += collection->size();
+        }
+    }
+    return num_hits;
+}
+
+
 //------------------------------------------------------------------------------
 // Constructor
 //
@@ -74,6 +285,42 @@ JEventSourcePODIO::JEventSourcePODIO(std::string resource_name, JApplication* ap
             "set to true to recycle through events continuously"
             );
 
+    GetApplication()->SetDefaultParameter(
+            "podio:num_readers",
+            m_num_readers,
+            "Number of files read concurrently when the input is a glob pattern or a .list file"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:read_ahead",
+            m_read_ahead,
+            "Number of events each reader thread may read ahead of the event processing"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:first_entry",
+            m_first_entry,
+            "Index of the first entry in the file to read. Entries before it are skipped without being read."
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:entries",
+            m_entries,
+            "Comma separated list of entry indices to read. All other entries are skipped without being read."
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:event_list",
+            m_event_list_filename,
+            "Name of a text file with one 'run event' pair per line. Only these events are read."
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:index_file",
+            m_index_filename,
+            "Name of the run/event number index file used with podio:event_list. It is created from the input file if it does not exist yet, or if it was made from another input file."
+            );
+
     bool print_type_table = false;
     GetApplication()->SetDefaultParameter(
             "podio:print_type_table",
@@ -81,59 +328,77 @@ JEventSourcePODIO::JEventSourcePODIO(std::string resource_name, JApplication* ap
             "Print list of collection names and their types"
             );
 
-    // Hopefully we won't need to reimplement background event merging. Using podio frames, it looks like we would
-    // have to do a deep copy of all data in order to insert it into the same frame, which would probably be
-    // quite inefficient.
-    /*
-    std::string background_filename;
     GetApplication()->SetDefaultParameter(
             "podio:background_filename",
-            background_filename,
+            m_background_filename,
             "Name of file containing background events to merge in (default is not to merge any background)"
             );
 
-    int num_background_events=1;
     GetApplication()->SetDefaultParameter(
             "podio:num_background_events",
-            num_background_events,
+            m_num_background_events,
             "Number of background events to add to every primary event."
-    );
-    */
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:background_pool_size",
+            m_background_pool_size,
+            "Number of background events to keep in memory. Background events are drawn randomly from this pool."
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:background_time_window",
+            m_background_time_window,
+            "Background hit times are shifted by a random offset drawn uniformly from [0, window) [ns]"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "podio:background_seed",
+            m_background_seed,
+            "Random number seed used to pick background events and their time offsets"
+            );
+    m_background_rng.seed(m_background_seed);
 }
 
 //------------------------------------------------------------------------------
 // Destructor
 //------------------------------------------------------------------------------
 JEventSourcePODIO::~JEventSourcePODIO() {
+    StopReaders();
     LOG << "Closing Event Source for " << GetResourceName() << LOG_END;
 }
 
 //------------------------------------------------------------------------------
 // Open
 //
-/// Open the root file and read in metadata.
+/// Open the root file and read in metadata. If the resource name expands to
+/// several files, the metadata is taken from the first one and the reader
+/// threads are started.
 //------------------------------------------------------------------------------
 void JEventSourcePODIO::Open() {
 
     bool print_type_table = GetApplication()->GetParameterValue<bool>("podio:print_type_table");
-    // std::string background_filename = GetApplication()->GetParameterValue<std::string>("podio:background_filename");;
-    // int num_background_events = GetApplication()->GetParameterValue<int>("podio:num_background_events");;
 
     // Open primary events file
     try {
 
-        // Verify file exists
-        if( ! std::filesystem::exists(GetResourceName()) ){
-            // Here we go against the standard practice of throwing an error and print
-            // the message and exit immediately. This is because we want the last message
-            // on the screen to be that the file doesn't exist.
-            auto mess = fmt::format(fmt::emphasis::bold | fg(fmt::color::red),"ERROR: ");
-            mess += fmt::format(fmt::emphasis::bold, "file: {} does not exist!",  GetResourceName());
-            std::cerr << std::endl << std::endl << mess << std::endl << std::endl;
-            std::_Exit(EXIT_FAILURE);
+        m_input_files = ExpandInputFiles(GetResourceName());
+        if( m_input_files.empty() ) m_input_files.push_back(GetResourceName()); // reported as missing below
+
+        // Verify files exist
+        for( const auto& filename : m_input_files ){
+            if( ! std::filesystem::exists(filename) ){
+                // Here we go against the standard practice of throwing an error and print
+                // the message and exit immediately. This is because we want the last message
+                // on the screen to be that the file doesn't exist.
+                auto mess = fmt::format(fmt::emphasis::bold | fg(fmt::color::red),"ERROR: ");
+                mess += fmt::format(fmt::emphasis::bold, "file: {} does not exist!",  filename);
+                std::cerr << std::endl << std::endl << mess << std::endl << std::endl;
+                std::_Exit(EXIT_FAILURE);
+            }
         }
 
-        m_reader.openFile( GetResourceName() );
+        m_reader.openFile( m_input_files.front() );
 
         auto version = m_reader.currentFileVersion();
         bool version_mismatch = version.major > podio::version::build_version.major;
@@ -147,8 +412,14 @@ void JEventSourcePODIO::Open() {
 
         LOG << "PODIO version: file=" << version << " (executable=" << podio::version::build_version << ")" << LOG_END;
 
-        Nevents_in_file = m_reader.getEntries("events");
-        LOG << "Opened PODIO Frame file \"" << GetResourceName() << "\" with " << Nevents_in_file << " events" << LOG_END;
+        if( m_input_files.size() == 1 ){
+            Nevents_in_file = m_reader.getEntries("events");
+            LOG << "Opened PODIO Frame file \"" << m_input_files.front() << "\" with " << Nevents_in_file << " events" << LOG_END;
+            SelectEntries();
+        }
+        else if( m_first_entry > 0 || ! m_entries.empty() || ! m_event_list_filename.empty() ){
+            throw JException( "podio:first_entry, podio:entries and podio:event_list only work with a single input file" );
+        }
 
         if( print_type_table ) PrintCollectionTypeTable();
 
@@ -157,6 +428,18 @@ void JEventSourcePODIO::Open() {
         throw JException( fmt::format( "Problem opening file \"{}\"", GetResourceName() ) );
     }
 
+    // Open background events file
+    if( ! m_background_filename.empty() ) {
+        try {
+            FillBackgroundPool();
+            FindSignalCollections();
+        }catch (std::exception &e ){
+            LOG_ERROR(default_cerr_logger) << e.what() << LOG_END;
+            throw JException( fmt::format( "Problem opening background file \"{}\"", m_background_filename ) );
+        }
+    }
+
+    if( m_input_files.size() > 1 ) StartReaders();
 }
 
 //------------------------------------------------------------------------------
@@ -167,6 +450,7 @@ void JEventSourcePODIO::Open() {
 /// \param event
 //------------------------------------------------------------------------------
 void JEventSourcePODIO::Close() {
+    StopReaders();
     // m_reader.close();
     // TODO: ROOTFrameReader does not appear to have a close() method.
 }
@@ -184,25 +468,38 @@ void JEventSourcePODIO::GetEvent(std::shared_ptr<JEvent> event) {
     /// Calls to GetEvent are synchronized with each other, which means they can
     /// read and write state on the JEventSource without causing race conditions.
 
-    // Check if we have exhausted events from file
-    if( Nevents_read >= Nevents_in_file ) {
-        if( m_run_forever ){
-            Nevents_read = 0;
-        }else{
-            // m_reader.close();
-            // TODO:: ROOTFrameReader does not appear to have a close() method.
-            throw RETURN_STATUS::kNO_MORE_EVENTS;
-        }
+    static const auto trace_get_event = Trace_service::NameId("JEventSourcePODIO:GetEvent");
+    Trace_service::Span span(trace_get_event, "source");
+
+    // Offer the event that was not admitted last time again, before reading a new one
+    InputFrames input_frames;
+    if( m_held_frames.frame ){
+        input_frames = std::move(m_held_frames);
+    }else{
+        input_frames = m_reader_threads.empty() ? ReadNextFrame() : PopQueuedFrame();
+
+        // Overlay background hits onto the signal hit collections
+        if( input_frames.signal_frame ) MergeBackground(*input_frames.frame, *input_frames.signal_frame);
     }
+    auto& frame = input_frames.frame;
 
-    auto frame_data = m_reader.readEntry("events", Nevents_read);
-    auto frame = std::make_unique<podio::Frame>(std::move(frame_data));
+    // With admission control (e.g. the memory plugin), keep the event until it is admitted.
+    // The ticket is freed, and the event leaves the budget, when JANA recycles the event
+    if (auto admission = eicrecon::JEventAdmission::Get()) {
+        auto ticket = admission->TryAdmit(CountSimHits(*frame));
+        if( !ticket ){
+            m_held_frames = std::move(input_frames);
+            throw RETURN_STATUS::kTRY_AGAIN;
+        }
+        event->Insert(ticket.release());
+    }
 
     auto& event_headers = frame->get<edm4hep::EventHeaderCollection>("EventHeader"); // TODO: What is the collection name?
     if (event_headers.size() != 1) {
         throw JException("Bad event headers: Entry %d contains %d items, but 1 expected.", Nevents_read, event_headers.size());
     }
     event->SetEventNumber(event_headers[0].getEventNumber());
+    span.SetEvent(event_headers[0].getEventNumber());
     event->SetRunNumber(event_headers[0].getRunNumber());
 
     // Insert contents odf frame into JFactories
@@ -217,6 +514,425 @@ void JEventSourcePODIO::GetEvent(std::shared_ptr<JEvent> event) {
     Nevents_read += 1;
 }
 
+//------------------------------------------------------------------------------
+// ReadNextFrame
+//
+/// Read the next entry of a single input file.
+//------------------------------------------------------------------------------
+JEventSourcePODIO::InputFrames JEventSourcePODIO::ReadNextFrame() {
+
+    // Check if we have exhausted events from file
+    size_t Nevents_to_read = m_selected_entries.empty() ? Nevents_in_file : m_selected_entries.size();
+    if( Nevents_read >= Nevents_to_read ) {
+        if( m_run_forever ){
+            Nevents_read = m_selected_entries.empty() ? std::min(m_first_entry, Nevents_in_file) : 0;
+            if( Nevents_read >= Nevents_to_read ) throw RETURN_STATUS::kNO_MORE_EVENTS;
+        }else{
+            // m_reader.close();
+            // TODO:: ROOTFrameReader does not appear to have a close() method.
+            throw RETURN_STATUS::kNO_MORE_EVENTS;
+        }
+    }
+
+    size_t entry = m_selected_entries.empty() ? Nevents_read : m_selected_entries[Nevents_read];
+    return MakeFrames(m_reader.readEntry("events", entry));
+}
+
+//------------------------------------------------------------------------------
+// MakeFrames
+//
+/// Make the frames of an input entry. Without background merging, this is just
+/// the event frame. Otherwise the signal collections to be merged are split off
+/// into the signal frame.
+//------------------------------------------------------------------------------
+JEventSourcePODIO::InputFrames JEventSourcePODIO::MakeFrames(std::unique_ptr<podio::ROOTFrameData> frame_data) {
+
+    if( ! m_signal_collections ) return {std::make_unique<podio::Frame>(std::move(frame_data)), nullptr};
+
+    std::shared_ptr<podio::ROOTFrameData> shared_data(std::move(frame_data));
+    return {
+        std::make_unique<podio::Frame>(std::make_unique<SplitFrameData>(shared_data, m_signal_collections, true)),
+        std::make_unique<podio::Frame>(std::make_unique<SplitFrameData>(shared_data, m_signal_collections, false))
+    };
+}
+
+//------------------------------------------------------------------------------
+// SelectEntries
+//
+/// Work out which entries of the input file to read from podio:first_entry,
+/// podio:entries and podio:event_list. Listed entries are read in file order,
+/// and entries before podio:first_entry are dropped from the lists as well, so
+/// that a restarted job can be given the same lists again.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::SelectEntries() {
+
+    Nevents_read = std::min(m_first_entry, Nevents_in_file);
+    if( m_entries.empty() && m_event_list_filename.empty() ){
+        if( m_first_entry > 0 ) LOG << "Skipping to entry " << m_first_entry << LOG_END;
+        return;
+    }
+
+    std::vector<size_t> entries = m_entries;
+
+    if( ! m_event_list_filename.empty() ){
+        std::ifstream event_list(m_event_list_filename);
+        if( ! event_list ){
+            throw JException( fmt::format( "Cannot open event list \"{}\"", m_event_list_filename ) );
+        }
+        auto index = GetEventIndex();
+        long run, event;
+        while( event_list >> run >> event ){
+            auto it = index.find({run, event});
+            if( it == index.end() ){
+                LOG_WARN(default_cerr_logger) << "Run " << run << " event " << event << " from event list not found in file" << LOG_END;
+                continue;
+            }
+            entries.push_back(it->second);
+        }
+    }
+
+    for( size_t entry : entries ){
+        if( entry < Nevents_in_file && entry >= m_first_entry ) m_selected_entries.push_back(entry);
+    }
+    std::sort(m_selected_entries.begin(), m_selected_entries.end());
+    m_selected_entries.erase(std::unique(m_selected_entries.begin(), m_selected_entries.end()), m_selected_entries.end());
+    Nevents_read = 0;
+
+    LOG << "Reading " << m_selected_entries.size() << " selected entries out of " << Nevents_in_file << LOG_END;
+
+    // An empty selection must not fall back to reading the whole file
+    if( m_selected_entries.empty() ) Nevents_in_file = 0;
+}
+
+//------------------------------------------------------------------------------
+// GetEventIndex
+//
+/// Return the map (run number, event number) -> entry of the input file. The
+/// map is read from podio:index_file if that exists and was made from the same
+/// input file. Otherwise it is built by reading only the EventHeader branch of
+/// the input file, and written to podio:index_file (if set) for the next job.
+/// The index file is plain text: a header of '# key value' lines naming the
+/// input file, its number of entries and its UUID, then one 'run event entry'
+/// triplet per line.
+//------------------------------------------------------------------------------
+std::map<std::pair<long, long>, size_t> JEventSourcePODIO::GetEventIndex() {
+
+    std::map<std::pair<long, long>, size_t> index;
+
+    std::unique_ptr<TFile> file = std::make_unique<TFile>(m_input_files.front().c_str());
+    auto* tree = file->Get<TTree>("events");
+    if( tree == nullptr ){
+        throw JException( fmt::format( "No events tree in \"{}\"", m_input_files.front() ) );
+    }
+    std::map<std::string, std::string> input_header = {
+        {"file", std::filesystem::absolute(m_input_files.front()).string()},
+        {"entries", std::to_string(tree->GetEntries())},
+        {"uuid", file->GetUUID().AsString()}
+    };
+
+    if( ! m_index_filename.empty() && std::filesystem::exists(m_index_filename) ){
+        std::ifstream index_file(m_index_filename);
+        std::map<std::string, std::string> index_header;
+        std::string line;
+        while( index_file.peek() == '#' && std::getline(index_file, line) ){
+            std::istringstream header_line(line.substr(1));
+            std::string key, value;
+            header_line >> key >> std::ws;
+            std::getline(header_line, value);
+            index_header[key] = value;
+        }
+        if( index_header == input_header ){
+            long run, event;
+            size_t entry;
+            while( index_file >> run >> event >> entry ) index[{run, event}] = entry;
+            LOG << "Read index of " << index.size() << " events from \"" << m_index_filename << "\"" << LOG_END;
+            return index;
+        }
+        LOG_WARN(default_cerr_logger) << "Index file \"" << m_index_filename << "\" was not made from \""
+            << m_input_files.front() << "\" as it is now (file, entries or UUID differ); rebuilding it" << LOG_END;
+    }
+
+    std::vector<edm4hep::EventHeaderData>* headers = nullptr;
+    tree->SetBranchStatus("*", false);
+    tree->SetBranchStatus("EventHeader", true);
+    tree->SetBranchAddress("EventHeader", &headers);
+    for( Long64_t entry = 0; entry < tree->GetEntries(); entry++ ){
+        tree->GetEntry(entry);
+        if( headers == nullptr || headers->size() != 1 ) continue;
+        index[{headers->front().runNumber, headers->front().eventNumber}] = entry;
+    }
+    tree->ResetBranchAddresses();
+    delete headers;  // allocated by ROOT on the first GetEntry
+
+    if( ! m_index_filename.empty() ){
+        std::ofstream index_file(m_index_filename);
+        for( const auto& [key, value] : input_header ) index_file << "# " << key << " " << value << "\n";
+        for( const auto& [run_event, entry] : index ){
+            index_file << run_event.first << " " << run_event.second << " " << entry << "\n";
+        }
+        LOG << "Wrote index of " << index.size() << " events to \"" << m_index_filename << "\"" << LOG_END;
+    }
+    return index;
+}
+
+//------------------------------------------------------------------------------
+// PopQueuedFrame
+//
+/// Take the next frame filled by the reader threads. Events of different files
+/// are interleaved in whatever order the readers deliver them. Rather than
+/// blocking the calling worker thread while the readers catch up, this gives
+/// JANA the chance to do other work by returning kTRY_AGAIN.
+//------------------------------------------------------------------------------
+JEventSourcePODIO::InputFrames JEventSourcePODIO::PopQueuedFrame() {
+
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+    bool ready = m_queue_not_empty.wait_for(lock, std::chrono::milliseconds(100), [this]{
+        return !m_frame_queue.empty() || m_active_readers == 0;
+    });
+    if( ! ready ) throw RETURN_STATUS::kTRY_AGAIN;
+    if( ! m_reader_error.empty() ) throw JException( m_reader_error );
+    if( m_frame_queue.empty() ) throw RETURN_STATUS::kNO_MORE_EVENTS;
+
+    auto input_frames = std::move(m_frame_queue.front());
+    m_frame_queue.pop_front();
+    lock.unlock();
+    m_queue_not_full.notify_one();
+    return input_frames;
+}
+
+//------------------------------------------------------------------------------
+// StartReaders
+//
+/// Start podio:num_readers threads (at most one per file) reading the input files.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::StartReaders() {
+
+    // Each reader thread has its own TFile
+    ROOT::EnableThreadSafety();
+
+    m_num_readers = std::clamp<size_t>(m_num_readers, 1, m_input_files.size());
+    m_read_ahead = std::max<size_t>(m_read_ahead, 1);
+    m_active_readers = m_num_readers;
+    for( size_t i = 0; i < m_num_readers; i++ ){
+        m_reader_threads.emplace_back(&JEventSourcePODIO::ReadFiles, this);
+    }
+
+    LOG << "Reading " << m_input_files.size() << " PODIO Frame files matching \"" << GetResourceName()
+        << "\" with " << m_num_readers << " reader threads" << LOG_END;
+}
+
+//------------------------------------------------------------------------------
+// StopReaders
+//
+/// Stop and join the reader threads and drop any frames still queued. Safe to
+/// call more than once.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::StopReaders() {
+
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        m_stop_readers = true;
+    }
+    m_queue_not_full.notify_all();
+    for( auto& thread : m_reader_threads ){
+        if( thread.joinable() ) thread.join();
+    }
+    m_frame_queue.clear();
+}
+
+//------------------------------------------------------------------------------
+// ReadFiles
+//
+/// Body of a reader thread. Claims input files one at a time until none are
+/// left, so that files of different sizes are balanced across the readers.
+/// Collections are unpacked here rather than in GetEvent to keep that work
+/// out of the synchronized part of the source.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::ReadFiles() {
+
+    static const auto trace_read       = Trace_service::NameId("JEventSourcePODIO:read");
+    static const auto trace_queue_wait = Trace_service::NameId("JEventSourcePODIO:queue_wait");
+
+    std::string current_file;
+    try {
+        bool stopped = false;
+        while( ! stopped ){
+            size_t ifile = m_next_input_file++;
+            if( ifile >= m_input_files.size() ){
+                if( ! m_run_forever ) break;
+                ifile %= m_input_files.size();
+            }
+            current_file = m_input_files[ifile];
+
+            podio::ROOTFrameReader reader;
+            reader.openFile( current_file );
+            size_t Nevents = reader.getEntries("events");
+
+            for( size_t entry = 0; entry < Nevents && ! stopped; entry++ ){
+                Trace_service::Span read_span(trace_read, "source");
+                auto input_frames = MakeFrames(reader.readEntry("events", entry));
+                for (auto* frame : {input_frames.frame.get(), input_frames.signal_frame.get()}) {
+                    if( frame == nullptr ) continue;
+                    for (const std::string& coll_name : frame->getAvailableCollections()) {
+                        frame->get(coll_name);
+                    }
+                }
+                read_span.End();
+
+                Trace_service::Span queue_wait_span(trace_queue_wait, "lock");
+                std::unique_lock<std::mutex> lock(m_queue_mutex);
+                m_queue_not_full.wait(lock, [this]{
+                    return m_stop_readers || m_frame_queue.size() < m_read_ahead * m_num_readers;
+                });
+                queue_wait_span.End();
+                stopped = m_stop_readers;
+                if( ! stopped ) m_frame_queue.push_back(std::move(input_frames));
+                lock.unlock();
+                m_queue_not_empty.notify_one();
+            }
+        }
+    }catch (std::exception &e ){
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        if( m_reader_error.empty() ) m_reader_error = fmt::format( "Problem reading file \"{}\": {}", current_file, e.what() );
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        m_active_readers--;
+    }
+    m_queue_not_empty.notify_all();
+}
+
+//------------------------------------------------------------------------------
+// ExpandInputFiles
+//
+/// Turn a resource name into the list of files to read. A name ending in
+/// ".list" is a text file with one input file per line (blank lines and lines
+/// starting with '#' are skipped). A name containing glob wildcards is matched
+/// against the file system; quote it on the command line so that the shell
+/// passes it through unexpanded. Any other name is returned as is.
+///
+/// \param resource_name  file name, glob pattern or list file
+/// \return              input files in the order they should be claimed
+//------------------------------------------------------------------------------
+std::vector<std::string> JEventSourcePODIO::ExpandInputFiles(const std::string& resource_name) {
+
+    std::vector<std::string> filenames;
+
+    const std::string list_suffix = ".list";
+    if( resource_name.size() > list_suffix.size()
+        && resource_name.compare(resource_name.size() - list_suffix.size(), list_suffix.size(), list_suffix) == 0 ){
+        std::ifstream list(resource_name);
+        std::string line;
+        while( std::getline(list, line) ){
+            line.erase(0, line.find_first_not_of(" \t"));
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if( line.empty() || line[0] == '#' ) continue;
+            filenames.push_back(line);
+        }
+        return filenames;
+    }
+
+    if( resource_name.find_first_of("*?[") != std::string::npos ){
+        glob_t matches;
+        if( glob(resource_name.c_str(), 0, nullptr, &matches) == 0 ){
+            for( size_t i = 0; i < matches.gl_pathc; i++ ) filenames.emplace_back(matches.gl_pathv[i]);
+        }
+        globfree(&matches);
+        return filenames;
+    }
+
+    filenames.push_back(resource_name);
+    return filenames;
+}
+
+//------------------------------------------------------------------------------
+// FillBackgroundPool
+//
+/// Read up to podio:background_pool_size events from the background file into
+/// memory. All collections are unpacked here so that the first signal events
+/// do not pay for it. The pool is never refilled; background events are recycled.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::FillBackgroundPool() {
+
+    if( ! std::filesystem::exists(m_background_filename) ){
+        throw JException( fmt::format( "Background file \"{}\" does not exist", m_background_filename ) );
+    }
+
+    podio::ROOTFrameReader background_reader;
+    background_reader.openFile( m_background_filename );
+
+    size_t Nevents_in_background_file = background_reader.getEntries("events");
+    if( Nevents_in_background_file == 0 ){
+        throw JException( fmt::format( "Background file \"{}\" contains no events", m_background_filename ) );
+    }
+
+    size_t pool_size = std::min(m_background_pool_size, Nevents_in_background_file);
+    m_background_pool.reserve(pool_size);
+    for( size_t entry = 0; entry < pool_size; entry++ ){
+        auto frame = std::make_unique<podio::Frame>(background_reader.readEntry("events", entry));
+        for (const std::string& coll_name : frame->getAvailableCollections()) {
+            frame->get(coll_name);
+        }
+        m_background_pool.push_back(std::move(frame));
+    }
+
+    LOG << "Opened PODIO background file \"" << m_background_filename << "\" with " << Nevents_in_background_file
+        << " events (" << pool_size << " kept in memory, " << m_num_background_events << " merged per event)" << LOG_END;
+}
+
+//------------------------------------------------------------------------------
+// FindSignalCollections
+//
+/// Find the collections of the signal file that background merging replaces: the
+/// MCParticles and all simulated hits and contributions, which refer to them. They
+/// are taken from the first entry of the (first) input file.
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::FindSignalCollections() {
+
+    auto signal_collections = std::make_shared<std::set<std::string>>();
+    signal_collections->insert("MCParticles");
+    if( m_reader.getEntries("events") > 0 ){
+        auto frame = std::make_unique<podio::Frame>(m_reader.readEntry("events", 0));
+        for (const std::string& coll_name : frame->getAvailableCollections()) {
+            const podio::CollectionBase* collection = frame->get(coll_name);
+            if (dynamic_cast<const edm4hep::SimTrackerHitCollection*>(collection) != nullptr ||
+                dynamic_cast<const edm4hep::SimCalorimeterHitCollection*>(collection) != nullptr ||
+                dynamic_cast<const edm4hep::CaloHitContributionCollection*>(collection) != nullptr) {
+                signal_collections->insert(coll_name);
+            }
+        }
+    }
+    m_signal_collections = std::move(signal_collections);
+}
+
+//------------------------------------------------------------------------------
+// MergeBackground
+//
+/// Merge the MCParticles and hits of podio:num_background_events randomly chosen
+/// background events with those of the signal frame, and put the merged collections
+/// into the event frame. All objects of one background event share the same random
+/// time offset.
+///
+/// \param frame         event frame, receives the merged collections
+/// \param signal_frame  signal MCParticles and hits split off from the event frame
+//------------------------------------------------------------------------------
+void JEventSourcePODIO::MergeBackground(podio::Frame& frame, const podio::Frame& signal_frame) {
+
+    /// Called only from GetEvent, so access to m_background_rng is synchronized.
+    std::uniform_int_distribution<size_t> pick_event(0, m_background_pool.size() - 1);
+    std::uniform_real_distribution<double> pick_time(0.0, m_background_time_window);
+
+    BackgroundMerger merger;
+    merger.Add(signal_frame, 0.0, false);
+    for( int i = 0; i < m_num_background_events; i++ ){
+        const auto& background_frame = m_background_pool[pick_event(m_background_rng)];
+        double time_offset = m_background_time_window > 0.0 ? pick_time(m_background_rng) : 0.0;
+        merger.Add(*background_frame, time_offset, true);
+    }
+    merger.Put(frame);
+}
+
 //------------------------------------------------------------------------------
 // GetDescription
 //------------------------------------------------------------------------------
@@ -235,26 +951,42 @@ std::string JEventSourcePODIO::GetDescription() {
 /// This will need to be made more sophisticated if the alternative root file
 /// formats need to be supported by other event sources.
 ///
+/// For a glob pattern or a list file only the first file is probed. Probe
+/// results are cached per file name, so a file is opened at most once here.
+///
 /// \param resource_name name of root file to evaluate.
 /// \return              value from 0-1 indicating confidence that this source can open the given file
 //------------------------------------------------------------------------------
 template <>
 double JEventSourceGeneratorT<JEventSourcePODIO>::CheckOpenable(std::string resource_name) {
 
+    auto input_files = JEventSourcePODIO::ExpandInputFiles(resource_name);
+    if (input_files.empty()) return 0.0;
+    const std::string& filename = input_files.front();
+
+    static std::mutex probe_mutex;
+    static std::map<std::string, double> probe_cache;
+    std::lock_guard<std::mutex> lock(probe_mutex);
+    auto cached = probe_cache.find(filename);
+    if (cached != probe_cache.end()) return cached->second;
+
     // PODIO Frame reader gets slightly higher precedence than PODIO Legacy reader, but only if the file
     // contains a 'podio_metadata' TTree. If the file doesn't exist, this will return 0. The "file not found"
     // error will hopefully be generated by the PODIO legacy reader instead.
-    if (resource_name.find(".root") == std::string::npos ) return 0.0;
+    double& result = probe_cache[filename];
+    result = 0.0;
+    if (filename.find(".root") == std::string::npos ) return result;
 
     // PODIO FrameReader segfaults on legacy input files, so we use ROOT to validate beforehand. Of course,
     // we can't validate if ROOT can't read the file.
-    std::unique_ptr<TFile> file = std::make_unique<TFile>(resource_name.c_str());
-    if (!file || file->IsZombie()) return 0.0;
+    std::unique_ptr<TFile> file = std::make_unique<TFile>(filename.c_str());
+    if (!file || file->IsZombie()) return result;
 
     // We test the format the same way that PODIO's python API does. See python/podio/reading.py
     TObject* tree = file->Get("podio_metadata");
-    if (tree == nullptr) return 0.0;
-    return 0.03;
+    if (tree == nullptr) return result;
+    result = 0.03;
+    return result;
 }
 
 //------------------------------------------------------------------------------
@@ -7,7 +7,20 @@
 #include <JANA/JEventSource.h>
 #include <JANA/JEventSourceGeneratorT.h>
 
+#include <podio/ROOTFrameData.h>
 #include <podio/ROOTFrameReader.h>
+#include <podio/Frame.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
 
 class JEventSourcePODIO : public JEventSource {
 
@@ -26,17 +39,82 @@ public:
 
     void PrintCollectionTypeTable(void);
 
+    void FillBackgroundPool(void);
+
+    void MergeBackground(podio::Frame& frame, const podio::Frame& signal_frame);
+
+    static std::vector<std::string> ExpandInputFiles(const std::string& resource_name);
+
+    void SelectEntries(void);
+
+    std::map<std::pair<long, long>, size_t> GetEventIndex(void);
+
 protected:
+    // The frames of one input entry. With background merging, the collections to be
+    // merged are split off from the event frame into the signal frame.
+    struct InputFrames {
+        std::unique_ptr<podio::Frame> frame;
+        std::unique_ptr<podio::Frame> signal_frame;   // nullptr without background merging
+    };
+
+    InputFrames MakeFrames(std::unique_ptr<podio::ROOTFrameData> frame_data);
+    InputFrames ReadNextFrame(void);
+    InputFrames PopQueuedFrame(void);
+    void FindSignalCollections(void);
+    void StartReaders(void);
+    void StopReaders(void);
+    void ReadFiles(void);
+
     podio::ROOTFrameReader m_reader;
     size_t Nevents_in_file = 0;
     size_t Nevents_read = 0;
 
+    // Entry selection (single input file only). If m_selected_entries is empty, all
+    // entries from m_first_entry on are read, otherwise only the listed ones.
+    size_t m_first_entry = 0;
+    std::vector<size_t> m_entries;
+    std::string m_event_list_filename;
+    std::string m_index_filename;
+    std::vector<size_t> m_selected_entries;
+
     std::string m_include_collections_str;
     std::string m_exclude_collections_str;
     std::set<std::string> m_INPUT_INCLUDE_COLLECTIONS;
     std::set<std::string> m_INPUT_EXCLUDE_COLLECTIONS;
     bool m_run_forever=false;
 
+    // Multi-file input. When the resource name expands to more than one file, each
+    // reader thread opens its own ROOTFrameReader on the next unclaimed file and pushes
+    // fully unpacked frames into a bounded queue that GetEvent drains.
+    std::vector<std::string> m_input_files;
+    size_t m_num_readers = 4;
+    size_t m_read_ahead = 16;  // queued frames per reader
+    std::vector<std::thread> m_reader_threads;
+    std::atomic<size_t> m_next_input_file{0};
+    std::mutex m_queue_mutex;
+    std::condition_variable m_queue_not_empty;
+    std::condition_variable m_queue_not_full;
+    std::deque<InputFrames> m_frame_queue;
+    size_t m_active_readers = 0;
+    bool m_stop_readers = false;
+    std::string m_reader_error;
+
+    // Background merging. Frames are read once into m_background_pool and recycled. The
+    // MCParticles and simulated hits of each signal entry (m_signal_collections) are
+    // copied, together with the background ones, into new collections of the event frame.
+    std::string m_background_filename;
+    int m_num_background_events = 1;
+    size_t m_background_pool_size = 100;
+    double m_background_time_window = 0.0;  // [ns]
+    unsigned long m_background_seed = 1;
+    std::vector<std::unique_ptr<podio::Frame>> m_background_pool;
+    std::mt19937_64 m_background_rng;
+    std::shared_ptr<const std::set<std::string>> m_signal_collections;
+
+    // Frames of the event that was not admitted (see JEventAdmission.h), offered again
+    // by the next call of GetEvent
+    InputFrames m_held_frames;
+
 };
 
 template <>
@@ -0,0 +1,405 @@
+// Copyright 2023, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+
+#include "JEventSourceSynthetic.h"
+
+#include <JANA/JApplication.h>
+#include <JANA/JEvent.h>
+
+#include <edm4hep/CaloHitContributionCollection.h>
+#include <edm4hep/EventHeaderCollection.h>
+#include <edm4hep/SimCalorimeterHitCollection.h>
+#include <edm4hep/SimTrackerHitCollection.h>
+
+#include <DD4hep/DD4hepUnits.h>
+#include <DD4hep/DetElement.h>
+#include <DD4hep/Readout.h>
+#include <TGeoBBox.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <set>
+
+#include "services/geometry/dd4hep/JDD4hep_service.h"
+#include "services/log/Log_service.h"
+#include "extensions/jana/JEventAdmission.h"
+
+
+//------------------------------------------------------------------------------
+// Constructor
+//
+///
+/// \param resource_name  "synthetic"
+/// \param app            JApplication
+//------------------------------------------------------------------------------
+JEventSourceSynthetic::JEventSourceSynthetic(std::string resource_name, JApplication* app) : JEventSource(resource_name, app) {
+    SetTypeName(NAME_OF_THIS); // Provide JANA with class name
+
+    GetApplication()->SetDefaultParameter(
+            "synthetic:nevents",
+            m_num_events,
+            "Number of events to generate (0 = no limit, e.g. to stop by jana:nevents)"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synthetic:num_particles",
+            m_num_particles,
+            "Number of MCParticles per event, which the generated hits refer to"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synthetic:tracker_hits",
+            m_num_tracker_hits,
+            "Number of SimTrackerHits per event in each tracker readout"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synthetic:calorimeter_hits",
+            m_num_calorimeter_hits,
+            "Number of SimCalorimeterHits per event in each calorimeter readout"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synthetic:readouts",
+            m_readout_names,
+            "Comma separated list of the readouts to generate hits for (default is all readouts of the geometry)"
+            );
+
+    GetApplication()->SetDefaultParameter(
+            "synthetic:seed",
+            m_seed,
+            "Random number seed of the generated events"
+            );
+    m_rng.seed(m_seed);
+}
+
+//------------------------------------------------------------------------------
+// Open
+//
+/// Load the geometry, and find the sensitive volumes of each readout that hits
+/// will be generated for.
+//------------------------------------------------------------------------------
+void JEventSourceSynthetic::Open() {
+
+    m_log = GetApplication()->GetService<Log_service>()->logger("JEventSourceSynthetic");
+    auto detector = GetApplication()->GetService<JDD4hep_service>()->detector();
+
+    std::set<std::string> selected(m_readout_names.begin(), m_readout_names.end());
+    for (const auto& [name, handle] : detector->sensitiveDetectors()) {
+        dd4hep::SensitiveDetector sensitive(handle);
+        dd4hep::Readout dd4hep_readout = sensitive.readout();
+        if (!dd4hep_readout.isValid()) continue;
+        if (!selected.empty() && selected.count(dd4hep_readout.name()) == 0) continue;
+
+        Readout readout{dd4hep_readout.name(), sensitive.type() == "calorimeter", dd4hep_readout.segmentation(), {}};
+        std::size_t num_found = 0;
+        try {
+            auto det_element = detector->detector(name);
+            auto placement = det_element.placement();
+            std::uint64_t volume_id = 0;
+            const auto* decoder = dd4hep_readout.idSpec().decoder();
+            for (const auto& [field, value] : placement.volIDs()) decoder->set(volume_id, field, value);
+            FindSensitiveVolumes(readout, *decoder, placement.ptr(), det_element.nominal().worldTransformation(), volume_id, num_found);
+        }
+        catch (std::exception& e) {
+            m_log->warn("Skipping readout {} of {}: {}", readout.name, name, e.what());
+            continue;
+        }
+        if (readout.volumes.empty()) {
+            m_log->warn("Skipping readout {} of {}: no sensitive volumes found", readout.name, name);
+            continue;
+        }
+        m_log->debug("Readout {} ({}): {} sensitive volumes, {} used", readout.name, sensitive.type(), num_found, readout.volumes.size());
+        m_readouts.push_back(std::move(readout));
+        selected.erase(m_readouts.back().name);
+    }
+
+    if (!m_readout_names.empty() && !selected.empty()) {
+        std::string missing;
+        for (const auto& name : selected) missing += (missing.empty() ? "" : ",") + name;
+        throw JException("synthetic:readouts lists readouts that are not in the geometry: %s", missing.c_str());
+    }
+    m_log->info("Generating {} MCParticles, {} hits per tracker readout and {} hits per calorimeter readout for {} readouts",
+                m_num_particles, m_num_tracker_hits, m_num_calorimeter_hits, m_readouts.size());
+}
+
+//------------------------------------------------------------------------------
+// FindSensitiveVolumes
+//
+/// Walk the placements below `node`, collecting the sensitive ones with their volume
+/// IDs into `readout`. Large detectors have millions of sensitive placements, so at
+/// most kMaxVolumesPerReadout of them are kept, sampled uniformly from all.
+///
+/// \param to_global   transformation of `node` to global coordinates
+/// \param volume_id   volume ID of `node`
+/// \param num_found   number of sensitive placements seen so far
+//------------------------------------------------------------------------------
+void JEventSourceSynthetic::FindSensitiveVolumes(Readout& readout, const dd4hep::BitFieldCoder& decoder,
+                                                 TGeoNode* node, const TGeoHMatrix& to_global,
+                                                 std::uint64_t volume_id, std::size_t& num_found) {
+
+    dd4hep::PlacedVolume placement(node);
+    if (placement.volume().isSensitive()) {
+        SensitiveVolume volume{volume_id, to_global, placement.volume().solid().ptr()};
+        num_found++;
+        if (readout.volumes.size() < kMaxVolumesPerReadout) {
+            readout.volumes.push_back(std::move(volume));
+        }
+        else {
+            std::uniform_int_distribution<std::size_t> pick(0, num_found - 1);
+            auto i = pick(m_rng);
+            if (i < kMaxVolumesPerReadout) readout.volumes[i] = std::move(volume);
+        }
+        return;
+    }
+
+    for (Int_t i = 0; i < node->GetNdaughters(); i++) {
+        TGeoNode* daughter = node->GetDaughter(i);
+        std::uint64_t daughter_id = volume_id;
+        for (const auto& [field, value] : dd4hep::PlacedVolume(daughter).volIDs()) decoder.set(daughter_id, field, value);
+        TGeoHMatrix daughter_to_global(to_global);
+        daughter_to_global.Multiply(daughter->GetMatrix());
+        FindSensitiveVolumes(readout, decoder, daughter, daughter_to_global, daughter_id, num_found);
+    }
+}
+
+//------------------------------------------------------------------------------
+// GetEvent
+//
+/// Generate the next event into a podio::Frame, and insert its collections into
+/// the given JEvent, like JEventSourcePODIO does with the frames it reads.
+///
+/// \param event
+//------------------------------------------------------------------------------
+void JEventSourceSynthetic::GetEvent(std::shared_ptr<JEvent> event) {
+
+    /// Calls to GetEvent are synchronized with each other, so m_rng needs no lock
+
+    if (m_num_events > 0 && Nevents_read >= m_num_events) throw RETURN_STATUS::kNO_MORE_EVENTS;
+
+    // Offer the event that was not admitted last time again, before generating a new one
+    auto frame = std::move(m_held_frame);
+    if (!frame) {
+        frame = std::make_unique<podio::Frame>();
+
+        edm4hep::EventHeaderCollection event_headers;
+        auto header = event_headers.create();
+        header.setEventNumber(Nevents_read);
+        header.setRunNumber(m_run_number);
+        frame->put(std::move(event_headers), "EventHeader");
+
+        GenerateParticles(*frame);
+        const auto& particles = frame->get<edm4hep::MCParticleCollection>("MCParticles");
+        m_held_cost = 0;
+        for (const auto& readout : m_readouts) {
+            if (readout.is_calorimeter) {
+                GenerateCalorimeterHits(*frame, readout, particles);
+                m_held_cost += 2 * m_num_calorimeter_hits;   // hits and their contributions
+            }
+            else {
+                GenerateTrackerHits(*frame, readout, particles);
+                m_held_cost += m_num_tracker_hits;
+            }
+        }
+    }
+
+    // With admission control (e.g. the memory plugin), keep the event until it is admitted
+    if (auto admission = eicrecon::JEventAdmission::Get()) {
+        auto ticket = admission->TryAdmit(m_held_cost);
+        if (!ticket) {
+            m_held_frame = std::move(frame);
+            throw RETURN_STATUS::kTRY_AGAIN;
+        }
+        event->Insert(ticket.release());
+    }
+
+    event->SetEventNumber(Nevents_read);
+    event->SetRunNumber(m_run_number);
+
+    const auto& particles = frame->get<edm4hep::MCParticleCollection>("MCParticles");
+    event->InsertCollectionAlreadyInFrame<edm4hep::EventHeader>(&frame->get<edm4hep::EventHeaderCollection>("EventHeader"), "EventHeader");
+    event->InsertCollectionAlreadyInFrame<edm4hep::MCParticle>(&particles, "MCParticles");
+    for (const auto& readout : m_readouts) {
+        if (readout.is_calorimeter) {
+            event->InsertCollectionAlreadyInFrame<edm4hep::SimCalorimeterHit>(&frame->get<edm4hep::SimCalorimeterHitCollection>(readout.name), readout.name);
+            event->InsertCollectionAlreadyInFrame<edm4hep::CaloHitContribution>(&frame->get<edm4hep::CaloHitContributionCollection>(readout.name + "Contributions"), readout.name + "Contributions");
+        }
+        else {
+            event->InsertCollectionAlreadyInFrame<edm4hep::SimTrackerHit>(&frame->get<edm4hep::SimTrackerHitCollection>(readout.name), readout.name);
+        }
+    }
+
+    event->Insert(frame.release()); // Transfer ownership from unique_ptr to JFactoryT<podio::Frame>
+    Nevents_read += 1;
+}
+
+//------------------------------------------------------------------------------
+// GenerateParticles
+//
+/// Stable particles from the origin, with isotropic directions and momenta of 0.5-20 GeV
+//------------------------------------------------------------------------------
+void JEventSourceSynthetic::GenerateParticles(podio::Frame& frame) {
+
+    struct Species { int pdg; float charge; double mass; /* [GeV] */ };
+    static const Species species[] = {
+        {  211,  1, 0.13957}, { -211, -1, 0.13957}, {  321,  1, 0.49368},
+        { 2212,  1, 0.93827}, {   11, -1, 0.00051}, {   22,  0, 0.0    },
+    };
+    std::uniform_int_distribution<std::size_t> pick_species(0, std::size(species) - 1);
+    std::uniform_real_distribution<double> pick_cos_theta(-1, 1);
+    std::uniform_real_distribution<double> pick_phi(-M_PI, M_PI);
+    std::uniform_real_distribution<double> pick_momentum(0.5, 20);
+
+    edm4hep::MCParticleCollection particles;
+    for (std::size_t i = 0; i < m_num_particles; i++) {
+        const auto& s = species[pick_species(m_rng)];
+        double p         = pick_momentum(m_rng);
+        double cos_theta = pick_cos_theta(m_rng);
+        double sin_theta = std::sqrt(1 - cos_theta * cos_theta);
+        double phi       = pick_phi(m_rng);
+
+        auto particle = particles.create();
+        particle.setPDG(s.pdg);
+        particle.setGeneratorStatus(1);
+        particle.setCharge(s.charge);
+        particle.setMass(s.mass);
+        particle.setTime(0);
+        particle.setVertex({0, 0, 0});
+        particle.setMomentum({
+            static_cast<float>(p * sin_theta * std::cos(phi)),
+            static_cast<float>(p * sin_theta * std::sin(phi)),
+            static_cast<float>(p * cos_theta)
+        });
+    }
+    frame.put(std::move(particles), "MCParticles");
+}
+
+//------------------------------------------------------------------------------
+// RandomPoint
+//
+/// Uniform in the volume, by sampling its bounding box
+//------------------------------------------------------------------------------
+void JEventSourceSynthetic::RandomPoint(const SensitiveVolume& volume, double local[3], double global[3]) {
+
+    const auto* box = dynamic_cast<const TGeoBBox*>(volume.shape);
+    if (box == nullptr) {
+        local[0] = local[1] = local[2] = 0;
+        volume.to_global.LocalToMaster(local, global);
+        return;
+    }
+    const double* origin = box->GetOrigin();
+    const double half_length[3] = {box->GetDX(), box->GetDY(), box->GetDZ()};
+    std::uniform_real_distribution<double> pick(-1, 1);
+
+    for (int attempt = 0; attempt < 10; attempt++) {
+        for (int j = 0; j < 3; j++) local[j] = origin[j] + half_length[j] * pick(m_rng);
+        if (volume.shape->Contains(local)) break;
+    }
+    // otherwise (e.g. thin shells) the last point, which is in the bounding box
+    volume.to_global.LocalToMaster(local, global);
+}
+
+//------------------------------------------------------------------------------
+// GenerateTrackerHits
+//------------------------------------------------------------------------------
+void JEventSourceSynthetic::GenerateTrackerHits(podio::Frame& frame, const Readout& readout, const edm4hep::MCParticleCollection& particles) {
+
+    std::uniform_int_distribution<std::size_t> pick_volume(0, readout.volumes.size() - 1);
+    std::uniform_int_distribution<std::size_t> pick_particle(0, std::max<std::size_t>(particles.size(), 1) - 1);
+    std::uniform_real_distribution<double> pick_time(0, 10);       // [ns]
+    std::exponential_distribution<double> pick_edep(1 / 100e-6);    // mean 100 keV [GeV]
+
+    edm4hep::SimTrackerHitCollection hits;
+    double local[3], global[3];
+    for (std::size_t i = 0; i < m_num_tracker_hits; i++) {
+        const auto& volume = readout.volumes[pick_volume(m_rng)];
+        RandomPoint(volume, local, global);
+        dd4hep::Position local_pos(local[0], local[1], local[2]);
+        dd4hep::Position global_pos(global[0], global[1], global[2]);
+
+        auto hit = hits.create();
+        hit.setCellID(readout.segmentation.isValid() ? readout.segmentation.cellID(local_pos, global_pos, volume.volume_id) : volume.volume_id);
+        hit.setEDep(pick_edep(m_rng));
+        hit.setTime(pick_time(m_rng));
+        hit.setPathLength(0.3);   // [mm]
+        hit.setQuality(0);
+        hit.setPosition({global[0] / dd4hep::mm, global[1] / dd4hep::mm, global[2] / dd4hep::mm});
+        if (!particles.empty()) {
+            auto particle = particles[pick_particle(m_rng)];
+            hit.setMomentum(particle.getMomentum());
+            hit.setMCParticle(particle);
+        }
+    }
+    frame.put(std::move(hits), readout.name);
+}
+
+//------------------------------------------------------------------------------
+// GenerateCalorimeterHits
+//
+/// One contribution per hit, in the "<readout>Contributions" collection
+//------------------------------------------------------------------------------
+void JEventSourceSynthetic::GenerateCalorimeterHits(podio::Frame& frame, const Readout& readout, const edm4hep::MCParticleCollection& particles) {
+
+    std::uniform_int_distribution<std::size_t> pick_volume(0, readout.volumes.size() - 1);
+    std::uniform_int_distribution<std::size_t> pick_particle(0, std::max<std::size_t>(particles.size(), 1) - 1);
+    std::uniform_real_distribution<double> pick_time(0, 10);      // [ns]
+    std::exponential_distribution<double> pick_energy(1 / 10e-3);  // mean 10 MeV [GeV]
+
+    edm4hep::SimCalorimeterHitCollection hits;
+    edm4hep::CaloHitContributionCollection contribs;
+    double local[3], global[3];
+    for (std::size_t i = 0; i < m_num_calorimeter_hits; i++) {
+        const auto& volume = readout.volumes[pick_volume(m_rng)];
+        RandomPoint(volume, local, global);
+        dd4hep::Position local_pos(local[0], local[1], local[2]);
+        dd4hep::Position global_pos(global[0], global[1], global[2]);
+        edm4hep::Vector3f position{
+            static_cast<float>(global[0] / dd4hep::mm),
+            static_cast<float>(global[1] / dd4hep::mm),
+            static_cast<float>(global[2] / dd4hep::mm)
+        };
+        double energy = pick_energy(m_rng);
+
+        auto hit = hits.create();
+        hit.setCellID(readout.segmentation.isValid() ? readout.segmentation.cellID(local_pos, global_pos, volume.volume_id) : volume.volume_id);
+        hit.setEnergy(energy);
+        hit.setPosition(position);
+
+        auto contrib = contribs.create();
+        contrib.setEnergy(energy);
+        contrib.setTime(pick_time(m_rng));
+        contrib.setStepPosition(position);
+        if (!particles.empty()) {
+            auto particle = particles[pick_particle(m_rng)];
+            contrib.setPDG(particle.getPDG());
+            contrib.setParticle(particle);
+        }
+        hit.addToContributions(contrib);
+    }
+    frame.put(std::move(hits), readout.name);
+    frame.put(std::move(contribs), readout.name + "Contributions");
+}
+
+//------------------------------------------------------------------------------
+// GetDescription
+//------------------------------------------------------------------------------
+std::string JEventSourceSynthetic::GetDescription() {
+
+    /// GetDescription() helps JANA explain to the user what is going on
+    return "Synthetic events with random hits in the loaded geometry";
+}
+
+//------------------------------------------------------------------------------
+// CheckOpenable
+//
+/// Only the resource name "synthetic" is opened by this source.
+///
+/// \param resource_name name of the resource to evaluate.
+/// \return              value from 0-1 indicating confidence that this source can open the given resource
+//------------------------------------------------------------------------------
+template <>
+double JEventSourceGeneratorT<JEventSourceSynthetic>::CheckOpenable(std::string resource_name) {
+    return resource_name == "synthetic" ? 1.0 : 0.0;
+}
@@ -0,0 +1,98 @@
+// Copyright 2023, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+
+#pragma once
+
+#include <JANA/JEventSource.h>
+#include <JANA/JEventSourceGeneratorT.h>
+
+#include <edm4hep/MCParticleCollection.h>
+#include <podio/Frame.h>
+#include <spdlog/spdlog.h>
+
+#include <DD4hep/Detector.h>
+#include <TGeoMatrix.h>
+#include <TGeoNode.h>
+#include <TGeoShape.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/// Generates events with random MCParticles and simulated tracker and calorimeter hits,
+/// in place of reading a simulation file, to test the reconstruction at any occupancy.
+/// Provided by the synthetic plugin, and selected by the resource name "synthetic", e.g.
+///
+///    eicrecon -Pplugins=synthetic -Psynthetic:calorimeter_hits=10000 -Pjana:nevents=100 synthetic
+///
+/// Hits are spread uniformly over the sensitive volumes of each readout of the loaded
+/// geometry, so their cellIDs and positions are valid for it. They are not correlated
+/// with the particles, which only serve as their MCParticle references: the events look
+/// like (a lot of) background, not like tracks and showers.
+class JEventSourceSynthetic : public JEventSource {
+
+public:
+    JEventSourceSynthetic(std::string resource_name, JApplication* app);
+
+    virtual ~JEventSourceSynthetic() = default;
+
+    void Open() override;
+
+    void GetEvent(std::shared_ptr<JEvent>) override;
+
+    static std::string GetDescription();
+
+protected:
+
+    /// A placement of a sensitive volume, with its volume ID and transformation to global coordinates
+    struct SensitiveVolume {
+        std::uint64_t volume_id;
+        TGeoHMatrix to_global;
+        const TGeoShape* shape;
+    };
+
+    /// Collection made for one readout
+    struct Readout {
+        std::string name;
+        bool is_calorimeter;
+        dd4hep::Segmentation segmentation;
+        std::vector<SensitiveVolume> volumes;  /// at most kMaxVolumesPerReadout, sampled from all
+    };
+
+    static constexpr std::size_t kMaxVolumesPerReadout = 10000;
+
+    void FindSensitiveVolumes(Readout& readout, const dd4hep::BitFieldCoder& decoder,
+                              TGeoNode* node, const TGeoHMatrix& to_global,
+                              std::uint64_t volume_id, std::size_t& num_found);
+
+    /// Random point in the volume, in its local [local] and global [global] coordinates
+    void RandomPoint(const SensitiveVolume& volume, double local[3], double global[3]);
+
+    void GenerateParticles(podio::Frame& frame);
+    void GenerateTrackerHits(podio::Frame& frame, const Readout& readout, const edm4hep::MCParticleCollection& particles);
+    void GenerateCalorimeterHits(podio::Frame& frame, const Readout& readout, const edm4hep::MCParticleCollection& particles);
+
+    std::shared_ptr<spdlog::logger> m_log;
+    std::vector<Readout> m_readouts;
+
+    size_t m_num_events = 100;             // 0 = no limit
+    size_t Nevents_read = 0;
+    int m_run_number = 1;
+    size_t m_num_particles = 10;
+    size_t m_num_tracker_hits = 100;       // per readout
+    size_t m_num_calorimeter_hits = 1000;  // per readout
+    std::vector<std::string> m_readout_names;
+    unsigned long m_seed = 1;
+    std::mt19937_64 m_rng;
+
+    /// Event that was not admitted (see JEventAdmission.h), offered again by the next
+    /// call of GetEvent, and its number of simulated hits
+    std::unique_ptr<podio::Frame> m_held_frame;
+    std::size_t m_held_cost = 0;
+};
+
+template <>
+double JEventSourceGeneratorT<JEventSourceSynthetic>::CheckOpenable(std::string);
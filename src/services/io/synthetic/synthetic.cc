@@ -0,0 +1,15 @@
+// Copyright 2023, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+//
+
+#include "JEventSourceSynthetic.h"
+
+
+// Make this a JANA plugin
+extern "C" {
+void InitPlugin(JApplication *app) {
+    InitJANAPlugin(app);
+    app->Add(new JEventSourceGeneratorT<JEventSourceSynthetic>());
+}
+}
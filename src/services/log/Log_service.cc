@@ -26,6 +26,11 @@ Log_service::~Log_service() {};
 
 std::shared_ptr<spdlog::logger> Log_service::logger(const std::string &name) {
 
+    // Loggers that were already made are found without m_lock or the spdlog registry
+    auto loggers = LoadLoggers();
+    auto it = loggers->find(name);
+    if(it != loggers->end()) return it->second;
+
     try {
         std::lock_guard<std::recursive_mutex> locker(m_lock);
 
@@ -41,6 +46,11 @@ std::shared_ptr<spdlog::logger> Log_service::logger(const std::string &name) {
             m_application->SetDefaultParameter(name+":LogLevel", log_level_str, "log_level for "+name+": trace, debug, info, warn, error, critical, off");
             logger->set_level(eicrecon::ParseLogLevel(log_level_str));
         }
+
+        // Publish the logger in a new copy of the map
+        auto updated = std::make_shared<LoggerMap>(*LoadLoggers());
+        (*updated)[name] = logger;
+        StoreLoggers(std::move(updated));
         return logger;
     }
     catch(const std::exception & exception) {
@@ -48,6 +58,23 @@ std::shared_ptr<spdlog::logger> Log_service::logger(const std::string &name) {
     }
 }
 
+// std::atomic<std::shared_ptr> replaces the std::atomic_load/store overloads, deprecated in C++20
+std::shared_ptr<const Log_service::LoggerMap> Log_service::LoadLoggers() const {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    return m_loggers.load();
+#else
+    return std::atomic_load(&m_loggers);
+#endif
+}
+
+void Log_service::StoreLoggers(std::shared_ptr<const LoggerMap> loggers) {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    m_loggers.store(std::move(loggers));
+#else
+    std::atomic_store(&m_loggers, std::move(loggers));
+#endif
+}
+
 spdlog::level::level_enum Log_service::getDefaultLevel() {return spdlog::default_logger()->level();}
 
 std::string Log_service::getDefaultLevelStr() {return eicrecon::LogLevelToString(getDefaultLevel());}
@@ -1,7 +1,11 @@
 #pragma once
 
 
+#include <atomic>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -19,6 +23,10 @@ public:
     explicit Log_service(JApplication *app);
     ~Log_service();
 
+    /** Gets the logger with this name, creating it on the first call.
+     * Loggers that already exist are found without m_lock and the spdlog registry, but
+     * not lock-free (see m_loggers); get the logger once (e.g. in Init) and keep the
+     * handle, rather than calling this per event **/
     virtual std::shared_ptr<spdlog::logger> logger(const std::string &name);
 
     /** Gets the default level for all loggers
@@ -33,7 +41,22 @@ private:
 
     Log_service()=default;
 
+    using LoggerMap = std::map<std::string, std::shared_ptr<spdlog::logger>>;
+
     std::recursive_mutex m_lock;
+    /// Loggers made so far. The map is never modified: a new logger is added to a copy,
+    /// which replaces it, so it can be read without m_lock. Reading it is not lock-free:
+    /// in libstdc++, std::atomic_load takes a mutex from a small pool shared by address
+    /// hash, and std::atomic<std::shared_ptr> a spin lock; either is held only while the
+    /// pointer is copied
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::atomic<std::shared_ptr<const LoggerMap>> m_loggers{std::make_shared<const LoggerMap>()};
+#else
+    std::shared_ptr<const LoggerMap> m_loggers = std::make_shared<const LoggerMap>();
+#endif
+
+    std::shared_ptr<const LoggerMap> LoadLoggers() const;
+    void StoreLoggers(std::shared_ptr<const LoggerMap> loggers);
     JApplication* m_application;
     std::string m_log_level_str;
 };
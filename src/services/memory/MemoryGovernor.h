@@ -0,0 +1,150 @@
+// Copyright 2023, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include "extensions/jana/JEventAdmission.h"
+
+class MemoryGovernor;
+
+/// Held by an event while it is in flight; inserted into the JEvent, so that it is
+/// destroyed, and releases the cost of the event, when JANA recycles the event
+class MemoryTicket : public eicrecon::JEventAdmissionTicket {
+public:
+    MemoryTicket(std::shared_ptr<MemoryGovernor> governor, std::size_t cost):
+            m_governor(std::move(governor)), m_cost(cost) {}
+    ~MemoryTicket() override;
+    MemoryTicket(const MemoryTicket&) = delete;
+    MemoryTicket& operator=(const MemoryTicket&) = delete;
+
+private:
+    std::shared_ptr<MemoryGovernor> m_governor;
+    std::size_t m_cost;
+};
+
+
+/// Admission control of events by resident memory; see MemoryGovernor_service
+class MemoryGovernor : public eicrecon::JEventAdmission, public std::enable_shared_from_this<MemoryGovernor> {
+public:
+
+    struct Stats {
+        std::size_t peak_resident   = 0;  /// [bytes]
+        std::size_t max_in_flight   = 0;  /// events
+        std::size_t num_throttled   = 0;  /// events that were refused at least once
+        std::size_t num_refused     = 0;  /// refused admissions, including repeated ones of the same event
+        double      throttled_time  = 0;  /// [s] from the first refusal until the admission of each event
+    };
+
+    MemoryGovernor(std::size_t budget, std::size_t min_events, std::shared_ptr<spdlog::logger> log = nullptr):
+            m_budget(budget), m_min_events(min_events), m_log(std::move(log)) {}
+
+    /// Admits an event costing `cost` (e.g. its number of simulated hits) if it fits the
+    /// memory budget, or if fewer than min_events are in flight; otherwise returns nullptr
+    /// and the source offers the event again later. The event is in flight until the
+    /// returned ticket is destroyed.
+    ///
+    /// Refused events are assumed to be offered again until admitted, as a JEventSource
+    /// does after kTRY_AGAIN, so the throttled time is measured from the first refusal
+    /// until the next admission
+    std::unique_ptr<eicrecon::JEventAdmissionTicket> TryAdmit(std::size_t cost) override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto resident = ResidentBytes();
+        LearnBytesPerCost(resident);
+        m_stats.peak_resident = std::max(m_stats.peak_resident, resident);
+
+        if (m_budget > 0 && m_in_flight_events >= m_min_events &&
+            resident + static_cast<std::size_t>(cost * m_bytes_per_cost) > m_budget) {
+            m_stats.num_refused++;
+            if (!m_throttled) {
+                m_throttled = true;
+                m_throttled_since = std::chrono::steady_clock::now();
+                if (m_stats.num_throttled++ == 0 && m_log) {
+                    m_log->info("Holding events back: resident {} MB, {} events in flight. Further events held back are only counted",
+                                resident >> 20, m_in_flight_events);
+                }
+                TrimHeap();
+            }
+            return nullptr;
+        }
+        if (m_throttled) {
+            m_throttled = false;
+            m_stats.throttled_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_throttled_since).count();
+        }
+
+        m_in_flight_events++;
+        m_in_flight_cost += cost;
+        m_stats.max_in_flight = std::max(m_stats.max_in_flight, m_in_flight_events);
+        return std::make_unique<MemoryTicket>(shared_from_this(), cost);
+    }
+
+    void Release(std::size_t cost) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_in_flight_events--;
+        m_in_flight_cost -= cost;
+    }
+
+    Stats GetStats() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.peak_resident = std::max(m_stats.peak_resident, ResidentBytes());
+        return m_stats;
+    }
+
+    /// Resident memory of the process [bytes], or 0 if unknown
+    static std::size_t ResidentBytes() {
+        auto file = std::fopen("/proc/self/statm", "r");
+        if (file == nullptr) return 0;
+        unsigned long size = 0, resident = 0;
+        auto num_read = std::fscanf(file, "%lu %lu", &size, &resident);
+        std::fclose(file);
+        return num_read == 2 ? resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) : 0;
+    }
+
+private:
+
+    /// Memory held by the events in flight, per unit of cost, from the resident memory
+    /// above what it is when no event is in flight
+    void LearnBytesPerCost(std::size_t resident) {
+        if (m_in_flight_events == 0) {
+            m_baseline = resident;
+            return;
+        }
+        if (m_in_flight_cost == 0 || resident <= m_baseline) return;
+        double bytes_per_cost = static_cast<double>(resident - m_baseline) / m_in_flight_cost;
+        m_bytes_per_cost = m_bytes_per_cost > 0 ? 0.9 * m_bytes_per_cost + 0.1 * bytes_per_cost : bytes_per_cost;
+    }
+
+    /// Returns freed heap memory to the system, which glibc otherwise keeps
+    static void TrimHeap() {
+#if defined(__GLIBC__)
+        malloc_trim(0);
+#endif
+    }
+
+    std::size_t m_budget;       /// [bytes], 0 = no limit
+    std::size_t m_min_events;   /// events always admitted
+    std::shared_ptr<spdlog::logger> m_log;
+
+    std::mutex m_mutex;
+    bool m_throttled = false;   /// the last admission was refused
+    std::chrono::steady_clock::time_point m_throttled_since;
+    std::size_t m_in_flight_events = 0;
+    std::size_t m_in_flight_cost = 0;
+    std::size_t m_baseline = 0;         /// [bytes] resident with no event in flight
+    double m_bytes_per_cost = 0;
+    Stats m_stats;
+};
+
+inline MemoryTicket::~MemoryTicket() { m_governor->Release(m_cost); }
@@ -0,0 +1,67 @@
+#pragma once
+
+
+#include <algorithm>
+#include <memory>
+
+#include <JANA/JApplication.h>
+#include <JANA/Services/JServiceLocator.h>
+
+#include "services/log/Log_service.h"
+#include "MemoryGovernor.h"
+
+
+/**
+ * This Service keeps the resident memory of the job within a budget by limiting the
+ * number of events in flight, rather than fixing it by the number of threads: memory
+ * per event varies by an order of magnitude between e.g. DIS and high background events.
+ *
+ * Enabled by loading the plugin: -Pplugins=memory -Pmemory:budget_mb=3500
+ *
+ * The governor is registered as the eicrecon::JEventAdmission of the job, and the event
+ * sources ask it to admit each event, with the number of simulated hits as its cost.
+ * Events are admitted while the resident memory, plus the expected memory of the event,
+ * is within the budget; otherwise the source keeps the event and returns kTRY_AGAIN, so
+ * JANA runs the events in flight meanwhile, and offers the event again on the next call.
+ * The source never waits, so a single thread (-Pnthreads=1) cannot block itself. The
+ * memory per hit is learned from the resident memory above what it is when no event is
+ * in flight. memory:min_events are always admitted, so the job progresses even if the
+ * budget is too small (e.g. below the memory of the geometry).
+ */
+class MemoryGovernor_service : public JService
+{
+public:
+    explicit MemoryGovernor_service(JApplication *app): m_app(app) {}
+
+    ~MemoryGovernor_service() override {
+        if (!m_governor) return;
+        eicrecon::JEventAdmission::Register(nullptr);
+        auto stats = m_governor->GetStats();
+        m_log->info("Peak resident memory {} MB (budget {}), up to {} events in flight",
+                    stats.peak_resident >> 20, m_budget_mb > 0 ? fmt::format("{} MB", m_budget_mb) : "none",
+                    stats.max_in_flight);
+        if (stats.num_throttled > 0) {
+            m_log->info("Held back {} events ({} refused admissions), for {:.1f} s in total",
+                        stats.num_throttled, stats.num_refused, stats.throttled_time);
+        }
+    }
+
+    void acquire_services(JServiceLocator *locater) override {
+        m_log = m_app->GetService<Log_service>()->logger("MemoryGovernor");
+        m_app->SetDefaultParameter("memory:budget_mb", m_budget_mb, "Resident memory budget of the job [MB]. Above it, no new events are read until events in flight are done. 0 = no limit, only report the peak");
+        m_app->SetDefaultParameter("memory:min_events", m_min_events, "Number of events in flight that are always admitted, regardless of memory");
+        m_governor = std::make_shared<MemoryGovernor>(m_budget_mb << 20, std::max<std::size_t>(m_min_events, 1), m_log);
+        eicrecon::JEventAdmission::Register(m_governor);
+        m_log->info("Memory budget {} MB, resident now {} MB", m_budget_mb, MemoryGovernor::ResidentBytes() >> 20);
+    }
+
+private:
+
+    MemoryGovernor_service()=default;
+
+    JApplication *m_app=nullptr;
+    std::shared_ptr<spdlog::logger> m_log;
+    std::size_t m_budget_mb = 0;
+    std::size_t m_min_events = 1;
+    std::shared_ptr<MemoryGovernor> m_governor;
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <JANA/JApplication.h>
+#include <JANA/Services/JGlobalRootLock.h>
+#include <JANA/Services/JServiceLocator.h>
+
+#include <TH1.h>
+
+#include "services/log/Log_service.h"
+#include "services/rootfile/RootFile_service.h"
+
+template <class T> class ThreadHistogram;
+
+/**
+ * This Service lets event processors fill histograms from all worker threads
+ * without the global root lock.
+ *
+ * A histogram is created as usual in Init, in a directory of the RootFile_service
+ * file, and registered with the service. Each thread then fills its own clone of
+ * it, which is made on the first fill of that thread. The clones are added to the
+ * registered histogram by Merge(), which processors can call in Finish, and which
+ * is called at the end of the job otherwise, before the file is written.
+ * e.g.
+ *
+ *    // Init
+ *    auto hist_service = app->GetService<ThreadHistogram_service>();
+ *    globalRootLock->acquire_write_lock();
+ *    root_file_service->GetHistFile()->mkdir("my_plugin")->cd();
+ *    m_th1_energy = hist_service->Register(new TH1D("energy", "Energy;GeV", 100, 0, 10));
+ *    globalRootLock->release_lock();
+ *
+ *    // Process, from any thread, without locking
+ *    m_th1_energy->Fill(energy);
+ */
+class ThreadHistogram_service : public JService
+{
+public:
+    explicit ThreadHistogram_service(JApplication *app): m_app(app) {}
+
+    ~ThreadHistogram_service() override { Merge(); }
+
+    void acquire_services(JServiceLocator *locater) override {
+        m_log = m_app->GetService<Log_service>()->logger("ThreadHistogram");
+        m_root_lock = m_app->GetService<JGlobalRootLock>();
+        // keep the file open until the histograms are merged
+        m_root_file = m_app->GetService<RootFile_service>();
+    }
+
+    /// Register a histogram to be filled by several threads. The histogram stays
+    /// owned by the caller (usually by its directory); call from Init. Give the
+    /// base class to keep handles of different types together, e.g. Register<TH1>(new TH1I(...))
+    template <class T>
+    ThreadHistogram<T> Register(T* hist) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_histograms.push_back({hist, {}});
+        return ThreadHistogram<T>(this, m_histograms.size() - 1, hist);
+    }
+
+    /// The clone of histogram `id` for the calling thread
+    TH1* ThreadClone(std::size_t id) {
+        auto& clones = ThreadClones();
+        if (id < clones.size() && clones[id] != nullptr) return clones[id];
+        return AddThreadClone(id);
+    }
+
+    /// Add the fills of all threads to the registered histograms. Only call when
+    /// no thread is filling, e.g. in Finish, and without holding the global root lock
+    void Merge() {
+        if (m_root_lock) m_root_lock->acquire_write_lock();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        std::size_t num_merged = 0;
+        for (auto& histogram : m_histograms) {
+            for (auto& clone : histogram.clones) {
+                if (clone->GetEntries() == 0) continue;
+                histogram.hist->Add(clone.get());
+                clone->Reset();
+                num_merged++;
+            }
+        }
+        lock.unlock();
+        if (m_root_lock) m_root_lock->release_lock();
+        if (m_log && num_merged > 0) m_log->debug("Merged {} thread histograms", num_merged);
+    }
+
+private:
+
+    struct Histogram {
+        TH1* hist;                                   /// registered histogram
+        std::vector<std::unique_ptr<TH1>> clones;    /// one per thread that filled it
+    };
+
+    /// Clones of the calling thread, by histogram id
+    static std::vector<TH1*>& ThreadClones() {
+        thread_local std::vector<TH1*> clones;
+        return clones;
+    }
+
+    TH1* AddThreadClone(std::size_t id) {
+        // TH1::Clone touches the global ROOT directory state. Lock in the same order
+        // as a processor registering histograms with the root lock held
+        m_root_lock->acquire_write_lock();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto& histogram = m_histograms.at(id);
+        auto clone = std::unique_ptr<TH1>(static_cast<TH1*>(histogram.hist->Clone()));
+        clone->SetDirectory(nullptr);
+        clone->Reset();
+        auto& clones = ThreadClones();
+        if (clones.size() <= id) clones.resize(id + 1, nullptr);
+        clones[id] = clone.get();
+        histogram.clones.push_back(std::move(clone));
+        lock.unlock();
+        m_root_lock->release_lock();
+        return clones[id];
+    }
+
+    ThreadHistogram_service()=default;
+
+    JApplication *m_app=nullptr;
+    std::shared_ptr<spdlog::logger> m_log;
+    std::shared_ptr<JGlobalRootLock> m_root_lock;
+    std::shared_ptr<RootFile_service> m_root_file;
+
+    std::mutex m_mutex;
+    std::vector<Histogram> m_histograms;
+};
+
+
+/// Handle of a histogram registered with ThreadHistogram_service
+template <class T>
+class ThreadHistogram {
+public:
+    ThreadHistogram() = default;
+
+    /// The histogram of the calling thread, to be filled
+    T* operator->() const { return static_cast<T*>(m_service->ThreadClone(m_id)); }
+
+    /// The registered histogram, which holds the fills of all threads after ThreadHistogram_service::Merge()
+    T* Merged() const { return m_hist; }
+
+private:
+    friend class ThreadHistogram_service;
+
+    ThreadHistogram(ThreadHistogram_service* service, std::size_t id, T* hist):
+            m_service(service), m_id(id), m_hist(hist) {}
+
+    ThreadHistogram_service* m_service = nullptr;
+    std::size_t m_id = 0;
+    T* m_hist = nullptr;
+};
@@ -4,11 +4,13 @@
 //
 
 #include "RootFile_service.h"
+#include "ThreadHistogram_service.h"
 
 
 extern "C" {
 void InitPlugin(JApplication *app) {
     InitJANAPlugin(app);
     app->ProvideService(std::make_shared<RootFile_service>(app) );
+    app->ProvideService(std::make_shared<ThreadHistogram_service>(app) );
 }
 }
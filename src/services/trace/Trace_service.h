@@ -0,0 +1,223 @@
+#pragma once
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <JANA/JApplication.h>
+#include <JANA/Services/JServiceLocator.h>
+#include <fmt/format.h>
+
+#include "services/log/Log_service.h"
+
+/**
+ * This Service records a timeline of spans (factory calls, lock waits, source reads)
+ * and writes it as a Chrome trace-event JSON file at the end of the job, which can be
+ * opened with chrome://tracing or https://ui.perfetto.dev
+ *
+ * Tracing is enabled by loading the plugin: -Pplugins=trace. Without it, a Span costs
+ * one atomic load. Each thread records into its own ring buffer of trace:buffer_size
+ * spans, so recording takes no locks; when a buffer is full, its oldest spans are
+ * overwritten.
+ *
+ * Instrumenting code:
+ *
+ *    static const auto trace_name = Trace_service::NameId("MyProcessor:lock_wait");
+ *    Trace_service::Span span(trace_name, "lock", event->GetEventNumber());
+ *    ... // the span ends when it goes out of scope, or with span.End()
+ */
+class Trace_service : public JService
+{
+    struct ThreadBuffer;
+
+public:
+
+    static constexpr std::uint64_t kNoEvent = std::numeric_limits<std::uint64_t>::max();
+
+    /// One recorded span
+    struct Record {
+        std::uint32_t name;      /// see NameId()
+        const char*   category;  /// string literal
+        std::uint64_t event;
+        std::int64_t  begin;     /// [ns] since the first span
+        std::int64_t  end;
+    };
+
+    /// Span recording the time from its construction to End() or its destruction
+    class Span {
+    public:
+        Span(std::uint32_t name, const char* category, std::uint64_t event = kNoEvent):
+                m_buffer(GetThreadBuffer()), m_record{name, category, event, 0, 0} {
+            if (m_buffer != nullptr) m_record.begin = Now();
+        }
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+        ~Span() { End(); }
+
+        /// Set the event number, if it is known only after the span started
+        void SetEvent(std::uint64_t event) { m_record.event = event; }
+
+        void End() {
+            if (m_buffer == nullptr) return;
+            m_record.end = Now();
+            m_buffer->Push(m_record);
+            m_buffer = nullptr;
+        }
+
+    private:
+        ThreadBuffer* m_buffer;
+        Record m_record;
+    };
+
+    explicit Trace_service(JApplication *app): m_app(app) {}
+
+    ~Trace_service() override {
+        Active().store(nullptr, std::memory_order_release);
+        Write();
+    }
+
+    void acquire_services(JServiceLocator *locater) override {
+        m_log = m_app->GetService<Log_service>()->logger("Trace");
+        m_app->SetDefaultParameter("trace:file", m_filename, "Name of the Chrome trace-event JSON file to be created");
+        m_app->SetDefaultParameter("trace:buffer_size", m_buffer_size, "Maximum number of spans kept per thread");
+        Active().store(this, std::memory_order_release);
+        m_log->info("Recording trace of up to {} spans per thread into {}", m_buffer_size, m_filename);
+    }
+
+    /// Id of a span name; names are kept for the whole job, so get the id once
+    /// and keep it, rather than per span
+    static std::uint32_t NameId(const std::string& name) {
+        auto& names = Names();
+        std::lock_guard<std::mutex> lock(names.mutex);
+        auto it = names.ids.find(name);
+        if (it != names.ids.end()) return it->second;
+        names.list.push_back(name);
+        return names.ids[name] = names.list.size() - 1;
+    }
+
+    /// True if spans are recorded
+    static bool IsActive() { return Active().load(std::memory_order_acquire) != nullptr; }
+
+private:
+
+    /// Ring buffer of the spans of one thread
+    struct ThreadBuffer {
+        std::size_t thread_index;
+        std::vector<Record> records;
+        std::size_t num_pushed = 0;
+
+        void Push(const Record& record) {
+            records[num_pushed % records.size()] = record;
+            num_pushed++;
+        }
+    };
+
+    struct NameTable {
+        std::mutex mutex;
+        std::map<std::string, std::uint32_t> ids;
+        std::vector<std::string> list;
+    };
+
+    static std::atomic<Trace_service*>& Active() {
+        static std::atomic<Trace_service*> active{nullptr};
+        return active;
+    }
+
+    static NameTable& Names() {
+        static NameTable names;
+        return names;
+    }
+
+    static std::int64_t Now() {
+        static const auto start = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /// Buffer of the calling thread, or nullptr if not tracing
+    static ThreadBuffer* GetThreadBuffer() {
+        auto service = Active().load(std::memory_order_acquire);
+        if (service == nullptr) return nullptr;
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (buffer == nullptr) buffer = service->AddThreadBuffer();
+        return buffer;
+    }
+
+    ThreadBuffer* AddThreadBuffer() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->thread_index = m_buffers.size();
+        buffer->records.resize(std::max<std::size_t>(m_buffer_size, 1));
+        m_buffers.push_back(std::move(buffer));
+        return m_buffers.back().get();
+    }
+
+    static std::string Escape(const std::string& str) {
+        std::string escaped;
+        for (char c : str) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    /// Write the trace; called at the end of the job, when the threads have stopped
+    void Write() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_buffers.empty() || m_filename.empty()) return;
+        std::ofstream file(m_filename);
+        if (!file) {
+            m_log->error("Cannot write trace to '{}'", m_filename);
+            return;
+        }
+
+        auto& names = Names();
+        std::lock_guard<std::mutex> names_lock(names.mutex);
+        std::size_t num_spans = 0, num_dropped = 0;
+        file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+        for (const auto& buffer : m_buffers) {
+            if (buffer->thread_index > 0) file << ",\n";
+            file << fmt::format(R"({{"name": "thread_name", "ph": "M", "pid": 1, "tid": {0}, "args": {{"name": "thread {0}"}}}})",
+                                buffer->thread_index);
+
+            // oldest first
+            auto size  = buffer->records.size();
+            auto count = std::min(buffer->num_pushed, size);
+            auto first = buffer->num_pushed - count;
+            for (std::size_t i = first; i < buffer->num_pushed; i++) {
+                const auto& record = buffer->records[i % size];
+                file << fmt::format(",\n" R"({{"name": "{}", "cat": "{}", "ph": "X", "ts": {:.3f}, "dur": {:.3f}, "pid": 1, "tid": {})",
+                                    Escape(names.list[record.name]), record.category,
+                                    1e-3 * record.begin, 1e-3 * (record.end - record.begin), buffer->thread_index);
+                if (record.event != kNoEvent) file << fmt::format(R"(, "args": {{"event": {}}})", record.event);
+                file << "}";
+            }
+            num_spans   += count;
+            num_dropped += buffer->num_pushed - count;
+        }
+        file << "\n]}\n";
+
+        m_log->info("Wrote {} spans of {} threads to {}", num_spans, m_buffers.size(), m_filename);
+        if (num_dropped > 0) {
+            m_log->warn("{} older spans were overwritten; increase trace:buffer_size to keep them", num_dropped);
+        }
+    }
+
+    Trace_service()=default;
+
+    JApplication *m_app=nullptr;
+    std::shared_ptr<spdlog::logger> m_log;
+    std::string m_filename = "eicrecon_trace.json";
+    std::size_t m_buffer_size = 1 << 16;
+
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+};
@@ -0,0 +1,14 @@
+// Copyright 2023, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+//
+//
+
+#include "Trace_service.h"
+
+
+extern "C" {
+void InitPlugin(JApplication *app) {
+    InitJANAPlugin(app);
+    app->ProvideService(std::make_shared<Trace_service>(app) );
+}
+}
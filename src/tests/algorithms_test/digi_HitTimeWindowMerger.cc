@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: LGPL-3.0-or-later
+// Copyright (C) 2023, Christopher Dilks
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "algorithms/digi/HitTimeWindowMerger.h"
+
+TEST_CASE("HitTimeWindowMerger groups hits by cell and time", "[HitTimeWindowMerger]") {
+  eicrecon::HitTimeWindowMerger merger;
+  const double EPSILON = 1e-9;
+
+  // hits, in no particular order
+  merger.Add(2, 10.0, 1.0); // 0
+  merger.Add(1, 30.0, 2.0); // 1
+  merger.Add(1,  5.0, 3.0); // 2
+  merger.Add(2, 12.0, 4.0); // 3
+  merger.Add(1,  7.0, 5.0); // 4
+  merger.Add(2, 25.0, 6.0); // 5
+
+  SECTION("within a time window") {
+    merger.Merge(5.0);
+    auto& groups = merger.GetGroups();
+    auto& order  = merger.GetOrder();
+    REQUIRE(groups.size() == 4);
+
+    // cell 1: {5, 7}, {30}
+    REQUIRE(groups[0].cellID == 1);
+    REQUIRE(groups[0].size() == 2);
+    REQUIRE_THAT(groups[0].time,   Catch::Matchers::WithinAbs(5.0, EPSILON));
+    REQUIRE_THAT(groups[0].charge, Catch::Matchers::WithinAbs(8.0, EPSILON));
+    REQUIRE(order[groups[0].begin] == 2);
+    REQUIRE(order[groups[0].begin + 1] == 4);
+    REQUIRE(groups[1].cellID == 1);
+    REQUIRE(groups[1].size() == 1);
+    REQUIRE(order[groups[1].begin] == 1);
+
+    // cell 2: {10, 12}, {25}
+    REQUIRE(groups[2].cellID == 2);
+    REQUIRE(groups[2].size() == 2);
+    REQUIRE_THAT(groups[2].time,   Catch::Matchers::WithinAbs(10.0, EPSILON));
+    REQUIRE_THAT(groups[2].charge, Catch::Matchers::WithinAbs(5.0, EPSILON));
+    REQUIRE(groups[3].cellID == 2);
+    REQUIRE_THAT(groups[3].charge, Catch::Matchers::WithinAbs(6.0, EPSILON));
+  }
+
+  SECTION("without a time window") {
+    merger.Merge(eicrecon::HitTimeWindowMerger::kNoWindow);
+    auto& groups = merger.GetGroups();
+    REQUIRE(groups.size() == 2);
+    REQUIRE(groups[0].size() == 3);
+    REQUIRE_THAT(groups[0].time,   Catch::Matchers::WithinAbs(5.0, EPSILON));
+    REQUIRE_THAT(groups[0].charge, Catch::Matchers::WithinAbs(10.0, EPSILON));
+    REQUIRE(groups[1].size() == 3);
+    REQUIRE_THAT(groups[1].time,   Catch::Matchers::WithinAbs(10.0, EPSILON));
+    REQUIRE_THAT(groups[1].charge, Catch::Matchers::WithinAbs(11.0, EPSILON));
+  }
+
+  SECTION("the window is measured from the first hit of the group") {
+    merger.Clear();
+    merger.Add(1, 0.0, 1.0);
+    merger.Add(1, 4.0, 1.0);
+    merger.Add(1, 8.0, 1.0);
+    merger.Merge(5.0, true);
+    auto& groups = merger.GetGroups();
+    REQUIRE(groups.size() == 2);
+    REQUIRE(groups[0].size() == 2);
+    REQUIRE_THAT(groups[1].time, Catch::Matchers::WithinAbs(8.0, EPSILON));
+  }
+}
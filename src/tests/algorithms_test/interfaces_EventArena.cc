@@ -0,0 +1,65 @@
+// Copyright 2023, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+
+#include <cstdint>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "algorithms/interfaces/EventArena.h"
+
+using eicrecon::EventArena;
+
+TEST_CASE("the EventArena is reused after the outermost scope ends", "[EventArena]") {
+
+  const int* first = nullptr;
+  {
+    EventArena::Scope scope;
+    EventArena::vector<int> values(EventArena::resource());
+    values.resize(100, 1);
+    first = values.data();
+  }
+
+  SECTION("a new scope starts from the beginning of the buffer") {
+    EventArena::Scope scope;
+    EventArena::vector<int> values(EventArena::resource());
+    values.resize(100, 2);
+    REQUIRE(values.data() == first);
+  }
+
+  SECTION("nested scopes do not reset the arena") {
+    EventArena::Scope outer;
+    EventArena::vector<int> outer_values(EventArena::resource());
+    outer_values.resize(100, 3);
+    {
+      EventArena::Scope inner;
+      EventArena::vector<int> inner_values(EventArena::resource());
+      inner_values.resize(100, 4);
+      REQUIRE(inner_values.data() != outer_values.data());
+    }
+    EventArena::vector<int> more_values(EventArena::resource());
+    more_values.resize(100, 5);
+    REQUIRE(more_values.data() != outer_values.data());
+    REQUIRE(outer_values[99] == 3);
+  }
+
+  SECTION("allocations larger than the buffer still succeed") {
+    EventArena::Scope scope;
+    EventArena::unordered_map<std::uint64_t, EventArena::vector<std::size_t>> map(EventArena::resource());
+    for (std::size_t i = 0; i < 100000; i++) map[i % 1000].push_back(i);
+    REQUIRE(map.size() == 1000);
+    REQUIRE(map[999].size() == 100);
+  }
+
+  SECTION("each thread has its own arena") {
+    const int* other = nullptr;
+    std::thread thread([&other] () {
+      EventArena::Scope scope;
+      EventArena::vector<int> values(EventArena::resource());
+      values.resize(100, 6);
+      other = values.data();
+    });
+    thread.join();
+    REQUIRE(other != first);
+  }
+}
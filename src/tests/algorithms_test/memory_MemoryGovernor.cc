@@ -0,0 +1,85 @@
+// Copyright 2023, Jefferson Science Associates, LLC.
+// Subject to the terms in the LICENSE file found in the top-level directory.
+
+#include <chrono>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "extensions/jana/JEventAdmission.h"
+#include "services/memory/MemoryGovernor.h"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("MemoryGovernor refuses events over the budget without waiting", "[MemoryGovernor]") {
+  // 1 byte: the resident memory is always over the budget, as when the geometry alone exceeds it
+  auto governor = std::make_shared<MemoryGovernor>(1, 1);
+
+  // as with -Pnthreads=1: the thread reading the next event holds the event before it,
+  // which can only be released once the thread gets to process it
+  auto first = governor->TryAdmit(100);
+  REQUIRE(first != nullptr);
+
+  auto start = std::chrono::steady_clock::now();
+  auto second = governor->TryAdmit(100);
+  auto again = governor->TryAdmit(100);
+  REQUIRE(std::chrono::steady_clock::now() - start < 1s);
+  REQUIRE(second == nullptr);
+  REQUIRE(again == nullptr);
+
+  // the source returns kTRY_AGAIN, the thread processes the first event, and the held
+  // event is admitted when it is offered again
+  first.reset();
+  second = governor->TryAdmit(100);
+  REQUIRE(second != nullptr);
+
+  auto stats = governor->GetStats();
+  REQUIRE(stats.num_throttled == 1);
+  REQUIRE(stats.num_refused == 2);
+  REQUIRE(stats.max_in_flight == 1);
+  REQUIRE(stats.throttled_time > 0);
+}
+
+TEST_CASE("MemoryGovernor always admits min_events", "[MemoryGovernor]") {
+  auto governor = std::make_shared<MemoryGovernor>(1, 2);
+
+  auto first = governor->TryAdmit(100);
+  auto second = governor->TryAdmit(100);
+  auto third = governor->TryAdmit(100);
+  REQUIRE(first != nullptr);
+  REQUIRE(second != nullptr);
+  REQUIRE(third == nullptr);
+
+  second.reset();
+  third = governor->TryAdmit(100);
+  REQUIRE(third != nullptr);
+  REQUIRE(governor->GetStats().max_in_flight == 2);
+}
+
+TEST_CASE("MemoryGovernor does not throttle without a budget", "[MemoryGovernor]") {
+  auto governor = std::make_shared<MemoryGovernor>(0, 1);
+
+  auto first = governor->TryAdmit(100);
+  auto second = governor->TryAdmit(100);
+  auto third = governor->TryAdmit(100);
+
+  auto stats = governor->GetStats();
+  REQUIRE(stats.num_throttled == 0);
+  REQUIRE(stats.max_in_flight == 3);
+  REQUIRE(stats.peak_resident > 0);
+}
+
+TEST_CASE("MemoryGovernor is found by event sources once registered", "[MemoryGovernor]") {
+  REQUIRE(eicrecon::JEventAdmission::Get() == nullptr);
+
+  auto governor = std::make_shared<MemoryGovernor>(0, 1);
+  eicrecon::JEventAdmission::Register(governor);
+  auto admission = eicrecon::JEventAdmission::Get();
+  REQUIRE(admission == governor);
+  {
+    auto ticket = admission->TryAdmit(100);
+    REQUIRE(ticket != nullptr);
+  }
+
+  eicrecon::JEventAdmission::Register(nullptr);
+  REQUIRE(eicrecon::JEventAdmission::Get() == nullptr);
+}
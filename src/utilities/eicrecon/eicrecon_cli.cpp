@@ -51,7 +51,9 @@ namespace jana {
 
         std::cout << "Example:" << std::endl;
         std::cout << "    eicrecon -Pplugins=plugin1,plugin2,plugin3 -Pnthreads=8 infile.root" << std::endl;
-        std::cout << "    eicrecon -Ppodio:print_type_table=1 infile.root" << std::endl << std::endl;
+        std::cout << "    eicrecon -Ppodio:print_type_table=1 infile.root" << std::endl;
+        std::cout << "    eicrecon -Peicrecon:lazy_factories=1 -Ppodio:output_include_collections=EcalBarrelClusters infile.root" << std::endl;
+        std::cout << "    eicrecon -Pplugins=synthetic -Psynthetic:nevents=100 -Psynthetic:calorimeter_hits=20000 synthetic" << std::endl << std::endl;
         std::cout << std::endl << std::endl;
     }
 